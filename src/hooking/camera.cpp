@@ -18,6 +18,7 @@ void CemuHooks::hook_BeginCameraSide(PPCInterpreter_t* hCPU) {
     if (layersInitialized && side == OpenXR::EyeSide::LEFT) {
         VRManager::instance().XR->GetRenderer()->StartFrame();
     }
+    renderer->m_perfStats.BeginEye(side);
 }
 
 static std::pair<glm::quat, glm::quat> swingTwistY(const glm::quat& q) {
@@ -401,6 +402,8 @@ void CemuHooks::hook_EndCameraSide(PPCInterpreter_t* hCPU) {
 
     OpenXR::EyeSide side = hCPU->gpr[3] == 0 ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
 
+    VRManager::instance().XR->GetRenderer()->m_perfStats.EndEye(side);
+
     // todo: sometimes this can deadlock apparently?
     if (VRManager::instance().XR->GetRenderer()->IsInitialized() && side == OpenXR::EyeSide::RIGHT) {
         VRManager::instance().XR->GetRenderer()->EndFrame();
@@ -1,5 +1,6 @@
 #pragma once
 #include "entity_debugger.h"
+#include "hook_profiler.h"
 
 
 class CemuHooks {
@@ -20,50 +21,50 @@ public:
         checkAssert(s_memoryBaseAddress != 0, "Failed to get memory base address of Cemu process!");
 
 
-        osLib_registerHLEFunction("coreinit", "hook_UpdateSettings", &hook_UpdateSettings);
+        RegisterHook<&hook_UpdateSettings>("hook_UpdateSettings");
 
         // Actor Hooks
-        osLib_registerHLEFunction("coreinit", "hook_UpdateActorList", &hook_UpdateActorList);
-        osLib_registerHLEFunction("coreinit", "hook_CreateNewActor", &hook_CreateNewActor);
+        RegisterHook<&hook_UpdateActorList>("hook_UpdateActorList");
+        RegisterHook<&hook_CreateNewActor>("hook_CreateNewActor");
 
         // Camera Hooks
-        osLib_registerHLEFunction("coreinit", "hook_BeginCameraSide", &hook_BeginCameraSide);
-        osLib_registerHLEFunction("coreinit", "hook_ModifyLightPrePassProjectionMatrix", &hook_ModifyLightPrePassProjectionMatrix);
-        osLib_registerHLEFunction("coreinit", "hook_UpdateCameraForGameplay", &hook_UpdateCameraForGameplay);
-        osLib_registerHLEFunction("coreinit", "hook_GetRenderCamera", &hook_GetRenderCamera);
-        osLib_registerHLEFunction("coreinit", "hook_GetRenderProjection", &hook_GetRenderProjection);
-        osLib_registerHLEFunction("coreinit", "hook_EndCameraSide", &hook_EndCameraSide);
-
-        osLib_registerHLEFunction("coreinit", "hook_UseCameraDistance", &hook_UseCameraDistance);
-        osLib_registerHLEFunction("coreinit", "hook_ReplaceCameraMode", &hook_ReplaceCameraMode);
-        osLib_registerHLEFunction("coreinit", "hook_GetEventName", &hook_GetEventName);
-        osLib_registerHLEFunction("coreinit", "hook_OverwriteCameraParam", &hook_OverwriteCameraParam);
-        osLib_registerHLEFunction("coreinit", "hook_PlayerLadderFix", &hook_PlayerLadderFix);
+        RegisterHook<&hook_BeginCameraSide>("hook_BeginCameraSide");
+        RegisterHook<&hook_ModifyLightPrePassProjectionMatrix>("hook_ModifyLightPrePassProjectionMatrix");
+        RegisterHook<&hook_UpdateCameraForGameplay>("hook_UpdateCameraForGameplay");
+        RegisterHook<&hook_GetRenderCamera>("hook_GetRenderCamera");
+        RegisterHook<&hook_GetRenderProjection>("hook_GetRenderProjection");
+        RegisterHook<&hook_EndCameraSide>("hook_EndCameraSide");
+
+        RegisterHook<&hook_UseCameraDistance>("hook_UseCameraDistance");
+        RegisterHook<&hook_ReplaceCameraMode>("hook_ReplaceCameraMode");
+        RegisterHook<&hook_GetEventName>("hook_GetEventName");
+        RegisterHook<&hook_OverwriteCameraParam>("hook_OverwriteCameraParam");
+        RegisterHook<&hook_PlayerLadderFix>("hook_PlayerLadderFix");
 
         // First-Person Model Hooks
-        osLib_registerHLEFunction("coreinit", "hook_SetActorOpacity", &hook_SetActorOpacity);
-        osLib_registerHLEFunction("coreinit", "hook_CalculateModelOpacity", &hook_CalculateModelOpacity);
-        osLib_registerHLEFunction("coreinit", "hook_ModifyBoneMatrix", &hook_ModifyBoneMatrix);
-        osLib_registerHLEFunction("coreinit", "hook_ChangeWeaponMtx", &hook_ChangeWeaponMtx);
+        RegisterHook<&hook_SetActorOpacity>("hook_SetActorOpacity");
+        RegisterHook<&hook_CalculateModelOpacity>("hook_CalculateModelOpacity");
+        RegisterHook<&hook_ModifyBoneMatrix>("hook_ModifyBoneMatrix");
+        RegisterHook<&hook_ChangeWeaponMtx>("hook_ChangeWeaponMtx");
 
         // First-Person Weapon Hooks
-        osLib_registerHLEFunction("coreinit", "hook_EquipWeapon", &hook_EquipWeapon);
-        osLib_registerHLEFunction("coreinit", "hook_DropEquipment", &hook_DropEquipment);
-        osLib_registerHLEFunction("coreinit", "hook_EnableWeaponAttackSensor", &hook_EnableWeaponAttackSensor);
-        osLib_registerHLEFunction("coreinit", "hook_SetPlayerWeaponScale", &hook_SetPlayerWeaponScale);
-        osLib_registerHLEFunction("coreinit", "hook_GetContactLayerOfAttack", &hook_GetContactLayerOfAttack);
+        RegisterHook<&hook_EquipWeapon>("hook_EquipWeapon");
+        RegisterHook<&hook_DropEquipment>("hook_DropEquipment");
+        RegisterHook<&hook_EnableWeaponAttackSensor>("hook_EnableWeaponAttackSensor");
+        RegisterHook<&hook_SetPlayerWeaponScale>("hook_SetPlayerWeaponScale");
+        RegisterHook<&hook_GetContactLayerOfAttack>("hook_GetContactLayerOfAttack");
 
         // Input Hooks
-        osLib_registerHLEFunction("coreinit", "hook_InjectXRInput", &hook_InjectXRInput);
-        osLib_registerHLEFunction("coreinit", "hook_XRRumble_VPADControlMotor", &hook_XRRumble_VPADControlMotor);
-        osLib_registerHLEFunction("coreinit", "hook_XRRumble_VPADStopMotor", &hook_XRRumble_VPADStopMotor);
+        RegisterHook<&hook_InjectXRInput>("hook_InjectXRInput");
+        RegisterHook<&hook_XRRumble_VPADControlMotor>("hook_XRRumble_VPADControlMotor");
+        RegisterHook<&hook_XRRumble_VPADStopMotor>("hook_XRRumble_VPADStopMotor");
 
         // Logging/Debugging Hooks
-        osLib_registerHLEFunction("coreinit", "hook_OSReportToConsole", &hook_OSReportToConsole);
-        osLib_registerHLEFunction("coreinit", "hook_DropWeaponLogging", &hook_DropWeaponLogging);
-        osLib_registerHLEFunction("coreinit", "hook_ModifyHandModelAccessSearch", &hook_ModifyHandModelAccessSearch);
-        osLib_registerHLEFunction("coreinit", "hook_CreateNewScreen", &hook_CreateNewScreen);
-        osLib_registerHLEFunction("coreinit", "hook_RouteActorJob", &hook_RouteActorJob);
+        RegisterHook<&hook_OSReportToConsole>("hook_OSReportToConsole");
+        RegisterHook<&hook_DropWeaponLogging>("hook_DropWeaponLogging");
+        RegisterHook<&hook_ModifyHandModelAccessSearch>("hook_ModifyHandModelAccessSearch");
+        RegisterHook<&hook_CreateNewScreen>("hook_CreateNewScreen");
+        RegisterHook<&hook_RouteActorJob>("hook_RouteActorJob");
     };
     ~CemuHooks() {
         FreeLibrary(m_cemuHandle);
@@ -175,6 +176,12 @@ public:
     static void DrawDebugOverlays();
 
 private:
+    // registers the hook with Cemu, wrapped so that its calls and latency show up in the hook profiler
+    template <HookProfiler::HookFunc Hook>
+    void RegisterHook(const char* name) {
+        osLib_registerHLEFunction("coreinit", name, HookProfiler::Wrap<Hook>(name));
+    }
+
     HMODULE m_cemuHandle;
 
     osLib_registerHLEFunctionPtr_t osLib_registerHLEFunction;
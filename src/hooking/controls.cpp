@@ -139,8 +139,8 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
         glm::fvec3 headsetForward = -glm::normalize(glm::fvec3(headsetMtx[2]));
         headsetForward.y = 0.0f;
         headsetForward = glm::normalize(headsetForward);
-        const auto leftHandPosition = ToGLM(inputs.inGame.poseLocation[0].pose.position);
-        const auto rightHandPosition = ToGLM(inputs.inGame.poseLocation[1].pose.position);
+        const auto leftHandPosition = ToGLM(inputs.inGame.filteredPoseLocation[0].pose.position);
+        const auto rightHandPosition = ToGLM(inputs.inGame.filteredPoseLocation[1].pose.position);
         const glm::fvec3 headToleftHand = leftHandPosition - headsetPosition;
         const glm::fvec3 headToRightHand = rightHandPosition - headsetPosition;
 
@@ -333,7 +333,7 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
             return glm::angleAxis(euler.y, glm::vec3(0, 1, 0));
         };
 
-        glm::fquat controllerRotation = ToGLM(inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].pose.orientation);
+        glm::fquat controllerRotation = ToGLM(inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::LEFT].pose.orientation);
         glm::fquat controllerYawRotation = isolateYaw(controllerRotation);
 
         glm::fquat moveRotation = inputs.inGame.pose[OpenXR::EyeSide::LEFT].isActive ? glm::inverse(VRManager::instance().XR->m_inputCameraRotation.load() * controllerYawRotation) : glm::identity<glm::fquat>();
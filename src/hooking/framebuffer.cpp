@@ -1,15 +1,19 @@
 #include "framebuffer.h"
 #include "instance.h"
 #include "layer.h"
+#include "utils/image_registry.h"
+#include "utils/layout_tracker.h"
+#include "utils/semaphore_table.h"
 #include "utils/vulkan_utils.h"
 
 
-std::mutex lockImageResolutions;
-std::unordered_map<VkImage, std::pair<VkExtent2D, VkFormat>> imageResolutions;
+ImageRegistry s_imageRegistry;
 
 std::mutex s_activeCopyMutex;
 std::vector<std::pair<VkCommandBuffer, SharedTexture*>> s_activeCopyOperations;
 
+// picked in the clear hooks and forgotten in DestroyImage, which Cemu calls from different threads
+std::mutex s_curr3DImagesMutex;
 VkImage s_curr3DColorImage = VK_NULL_HANDLE;
 VkImage s_curr3DDepthImage = VK_NULL_HANDLE;
 
@@ -18,25 +22,40 @@ using namespace VRLayer;
 VkResult VkDeviceOverrides::CreateImage(const vkroots::VkDeviceDispatch* pDispatch, VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage) {
     VkResult res = pDispatch->CreateImage(device, pCreateInfo, pAllocator, pImage);
 
-    if (pCreateInfo->extent.width >= 1280 && pCreateInfo->extent.height >= 720) {
-        lockImageResolutions.lock();
+    if (res == VK_SUCCESS && ImageRegistry::IsTracked(pCreateInfo)) {
         // Log::print("Added texture {}: {}x{} @ {}", (void*)*pImage, pCreateInfo->extent.width, pCreateInfo->extent.height, pCreateInfo->format);
-        checkAssert(imageResolutions.try_emplace(*pImage, std::make_pair(VkExtent2D{ pCreateInfo->extent.width, pCreateInfo->extent.height }, pCreateInfo->format)).second, "Couldn't insert image resolution into map!");
-        lockImageResolutions.unlock();
+        checkAssert(s_imageRegistry.Register(*pImage, pCreateInfo), "Couldn't insert image resolution into map!");
+
+        // Cemu creates its new framebuffers before it starts using them, so the textures for the new resolution can already be created in the background
+        auto* renderer = VRManager::instance().XR ? VRManager::instance().XR->GetRenderer() : nullptr;
+        if (renderer && renderer->m_layer2D && pCreateInfo->format == VK_FORMAT_B10G11R11_UFLOAT_PACK32) {
+            const VkExtent2D layerExtent = renderer->m_layer2D->GetExtent();
+            const VkExtent2D extent = { pCreateInfo->extent.width, pCreateInfo->extent.height };
+            // skip the smaller render targets (e.g. bloom) that Cemu creates along with it
+            const bool sameAspectRatio = (uint64_t)extent.width * layerExtent.height == (uint64_t)extent.height * layerExtent.width;
+            const bool sameExtent = extent.width == layerExtent.width && extent.height == layerExtent.height;
+            if (sameAspectRatio && !sameExtent && extent.width > layerExtent.width / 2) {
+                Log::print<VERBOSE>("Preallocating layer textures for new resolution {}x{}", extent.width, extent.height);
+                renderer->m_texturePool.Preallocate(SharedTexturePool::MakeKey(extent, VK_FORMAT_B10G11R11_UFLOAT_PACK32), 4);
+                renderer->m_texturePool.Preallocate(SharedTexturePool::MakeKey(extent, VK_FORMAT_D32_SFLOAT), 4);
+                renderer->m_texturePool.Preallocate(SharedTexturePool::MakeKey(extent, VK_FORMAT_A2B10G10R10_UNORM_PACK32), 2);
+            }
+        }
     }
     return res;
 }
 
 void VkDeviceOverrides::DestroyImage(const vkroots::VkDeviceDispatch* pDispatch, VkDevice device, VkImage image, const VkAllocationCallbacks* pAllocator) {
-    lockImageResolutions.lock();
-    imageResolutions.erase(image);
-    if (s_curr3DColorImage == image) {
-        s_curr3DColorImage = VK_NULL_HANDLE;
-    }
-    else if (s_curr3DDepthImage == image) {
-        s_curr3DDepthImage = VK_NULL_HANDLE;
+    s_imageRegistry.Unregister(image);
+    {
+        std::scoped_lock lock(s_curr3DImagesMutex);
+        if (s_curr3DColorImage == image) {
+            s_curr3DColorImage = VK_NULL_HANDLE;
+        }
+        else if (s_curr3DDepthImage == image) {
+            s_curr3DDepthImage = VK_NULL_HANDLE;
+        }
     }
-    lockImageResolutions.unlock();
 
     pDispatch->DestroyImage(device, image, pAllocator);
 }
@@ -57,41 +76,8 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
     }
 
     if (side != (OpenXR::EyeSide)-1) {
-        // Track original layout so we can restore after copies
-        const VkImageLayout originalLayout = imageLayout;
-        bool transitionedToSrc = false;
-        auto ensureSrcLayout = [&]() {
-            if (!transitionedToSrc) {
-                VulkanUtils::TransitionLayout(commandBuffer, image, originalLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-                transitionedToSrc = true;
-            }
-        };
-        auto restoreLayout = [&]() {
-            if (transitionedToSrc) {
-                VulkanUtils::TransitionLayout(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, originalLayout);
-                transitionedToSrc = false;
-            }
-        };
-        // AMD GPU FIX: Helper to transition to TRANSFER_DST_OPTIMAL for copy-to operations
-        bool transitionedToDst = false;
-        auto ensureDstLayout = [&]() {
-            if (transitionedToSrc) {
-                // Currently in TRANSFER_SRC, transition to TRANSFER_DST
-                VulkanUtils::TransitionLayout(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-                transitionedToSrc = false;
-                transitionedToDst = true;
-            } else if (!transitionedToDst) {
-                // Currently in original layout, transition to TRANSFER_DST
-                VulkanUtils::TransitionLayout(commandBuffer, image, originalLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-                transitionedToDst = true;
-            }
-        };
-        auto restoreFromDst = [&]() {
-            if (transitionedToDst) {
-                VulkanUtils::TransitionLayout(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, originalLayout);
-                transitionedToDst = false;
-            }
-        };
+        // Track the original layout, all transitions of the image go through the tracker so that it can be restored after the copies
+        ImageLayoutTracker imageLayoutTracker(image, VK_IMAGE_ASPECT_COLOR_BIT, imageLayout);
 
         // r value in magical clear value is the capture idx after rounding down
         const long captureIdx = std::lroundf(pColor->float32[0] * 32.0f);
@@ -112,13 +98,12 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
         // initialize the textures of both 2D and 3D layer if either is found since they share the same VkImage and resolution
         if (captureIdx == 0 || captureIdx == 2) {
             if (!layer2D) {
-                lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
-                    layer3D = std::make_unique<RND_Renderer::Layer3D>(it->second.first);
-                    layer2D = std::make_unique<RND_Renderer::Layer2D>(it->second.first);
+                if (const auto imageInfo = s_imageRegistry.Find(image)) {
+                    layer3D = std::make_unique<RND_Renderer::Layer3D>(renderer->m_texturePool, imageInfo->extent);
+                    layer2D = std::make_unique<RND_Renderer::Layer2D>(renderer->m_texturePool, imageInfo->extent);
 
-                    // Log::print("Found rendering resolution {}x{} @ {} using capture #{}", it->second.first.width, it->second.first.height, it->second.second, captureIdx);
-                    imguiOverlay = std::make_unique<RND_Renderer::ImGuiOverlay>(commandBuffer, it->second.first.width, it->second.first.height, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
+                    // Log::print("Found rendering resolution {}x{} @ {} using capture #{}", imageInfo->extent.width, imageInfo->extent.height, imageInfo->format, captureIdx);
+                    imguiOverlay = std::make_unique<RND_Renderer::ImGuiOverlay>(commandBuffer, imageInfo->extent.width, imageInfo->extent.height, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
                     if (CemuHooks::GetSettings().ShowDebugOverlay()) {
                         VRManager::instance().Hooks->m_entityDebugger = std::make_unique<EntityDebugger>();
                     }
@@ -126,7 +111,15 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
                 else {
                     checkAssert(false, "Couldn't find image resolution in map!");
                 }
-                lockImageResolutions.unlock();
+            }
+            else if (const auto imageInfo = s_imageRegistry.Find(image); imageInfo && (imageInfo->extent.width != layer2D->GetExtent().width || imageInfo->extent.height != layer2D->GetExtent().height)) {
+                // Cemu's resolution changed (e.g. through a graphic pack), the old textures are returned to the pool instead of waiting for the GPU here
+                Log::print<INFO>("Rendering resolution changed from {}x{} to {}x{}", layer2D->GetExtent().width, layer2D->GetExtent().height, imageInfo->extent.width, imageInfo->extent.height);
+                layer3D->Resize(imageInfo->extent);
+                layer2D->Resize(imageInfo->extent);
+                if (imguiOverlay) {
+                    imguiOverlay->Resize(commandBuffer, imageInfo->extent.width, imageInfo->extent.height);
+                }
             }
         }
 
@@ -139,14 +132,15 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
             // 3D layer - color texture for 3D rendering
 
             // check if the color texture has the appropriate texture format
-            if (s_curr3DColorImage == VK_NULL_HANDLE) {
-                lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
-                    if (it->second.second == VK_FORMAT_B10G11R11_UFLOAT_PACK32) {
-                        s_curr3DColorImage = it->first;
+            VkImage curr3DColorImage = VK_NULL_HANDLE;
+            {
+                std::scoped_lock lock(s_curr3DImagesMutex);
+                if (s_curr3DColorImage == VK_NULL_HANDLE) {
+                    if (const auto imageInfo = s_imageRegistry.Find(image); imageInfo && imageInfo->stereoCandidate && imageInfo->format == VK_FORMAT_B10G11R11_UFLOAT_PACK32) {
+                        s_curr3DColorImage = image;
                     }
                 }
-                lockImageResolutions.unlock();
+                curr3DColorImage = s_curr3DColorImage;
             }
 
             // don't clear the image if we're in the faux 2D mode
@@ -154,8 +148,8 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
                 return;
             }
 
-            if (image != s_curr3DColorImage) {
-                Log::print<RENDERING>("Color image is not the same as the current 3D color image! ({} != {})", (void*)image, (void*)s_curr3DColorImage);
+            if (image != curr3DColorImage) {
+                Log::print<RENDERING>("Color image is not the same as the current 3D color image! ({} != {})", (void*)image, (void*)curr3DColorImage);
                 // AMD GPU FIX: Use local VkClearColorValue instead of const_cast to avoid UB
                 VkClearColorValue clearColor;
                 if (VRManager::instance().XR->GetRenderer()->IsRendering3D(frameIdx)) {
@@ -167,55 +161,52 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
                 return pDispatch->CmdClearColorImage(commandBuffer, image, imageLayout, &clearColor, rangeCount, pRanges);
             }
 
-            if (renderer->GetFrame(frameIdx).copiedColor[side]) {
+            if (renderer->Is3DColorCopied(side, frameIdx)) {
                 // the color texture has already been copied to the layer
                 Log::print<RENDERING>("A 3D color texture is already been copied for the current frame!");
+                if (side == OpenXR::EyeSide::LEFT) {
+                    renderer->m_perfStats.AddDuplicatedFrame();
+                }
                 // AMD GPU FIX: Use local VkClearColorValue instead of const_cast to avoid UB
                 VkClearColorValue clearColor = {{ 0.0f, 0.0f, 0.0f, 0.0f }};
                 return pDispatch->CmdClearColorImage(commandBuffer, image, imageLayout, &clearColor, rangeCount, pRanges);
             }
 
             // note: This uses vkCmdCopyImage to copy the image to an OpenXR-specific texture. s_activeCopyOperations queues a semaphore for the D3D12 side to wait on.
-            // AMD GPU FIX: ensureSrcLayout transitions to TRANSFER_SRC_OPTIMAL, then pass that layout so copy functions skip internal transitions
-            ensureSrcLayout();
-            SharedTexture* texture = layer3D->CopyColorToLayer(side, commandBuffer, image, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            // All copies from this image share one barrier before and one after them, which also restores the image to its original layout
+            CopyBatch copyBatch;
+            imageLayoutTracker.Transition(copyBatch.PreCopy(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            SharedTexture* texture = layer3D->CopyColorToLayer(side, commandBuffer, copyBatch, image, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
             renderer->On3DColorCopied(side, frameIdx);
             // Log::print("[VULKAN] Waiting for {} side to be 0", side == OpenXR::EyeSide::LEFT ? "left" : "right");
             // AMD GPU FIX: Protect s_activeCopyOperations with mutex
-            {
+            if (texture) {
                 std::lock_guard<std::mutex> lk(s_activeCopyMutex);
                 s_activeCopyOperations.emplace_back(commandBuffer, texture);
             }
-            // AMD GPU FIX: Removed incorrect TransitionLayout(GENERAL, GENERAL) - CopyFromVkImage already handles layout transitions
-            // DebugPipelineBarrier provides memory synchronization without incorrect layout claims
-            VulkanUtils::DebugPipelineBarrier(commandBuffer);
 
             // imgui needs only one eye to render Cemu's 2D output, so use right side since it looks better
             if (side == EyeSide::RIGHT) {
                 // note: Uses vkCmdCopyImage to copy the (right-eye-only) image to the imgui overlay's texture
-                // AMD GPU FIX: Image is already in TRANSFER_SRC_OPTIMAL from ensureSrcLayout
                 float aspectRatio = layer3D->GetAspectRatio(side);
-                imguiOverlay->Draw3DLayerAsBackground(commandBuffer, image, aspectRatio, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-
-                VulkanUtils::DebugPipelineBarrier(commandBuffer);
+                imguiOverlay->Draw3DLayerAsBackground(copyBatch, image, aspectRatio, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
             }
 
-            // AMD GPU FIX: Restore layout BEFORE CmdClearColorImage
+            // AMD GPU FIX: The post-copy barrier restores the original layout BEFORE CmdClearColorImage
             // CmdClearColorImage requires GENERAL or TRANSFER_DST_OPTIMAL, not TRANSFER_SRC_OPTIMAL
-            restoreLayout();
+            imageLayoutTracker.Restore(copyBatch.PostCopy());
+            copyBatch.Record(commandBuffer);
 
             // clear the image to be transparent to allow for the HUD to be rendered on top of it which results in a transparent HUD layer
             // AMD GPU FIX: Use local VkClearColorValue instead of const_cast to avoid UB
             VkClearColorValue clearColor = {{ 0.0f, 0.0f, 0.0f, 0.0f }};
             pDispatch->CmdClearColorImage(commandBuffer, image, imageLayout, &clearColor, rangeCount, pRanges);
-
-            VulkanUtils::DebugPipelineBarrier(commandBuffer);
             return;
         }
         else if (captureIdx == 2) {
             // 2D layer - color texture for HUD rendering
 
-            bool hudCopied = renderer->GetFrame(frameIdx).copied2D;
+            bool hudCopied = renderer->Is2DCopied(frameIdx);
 
             if (side == OpenXR::EyeSide::LEFT) {
                 if (hudCopied) {
@@ -227,11 +218,12 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
                 }
                 else {
                     // provide the HUD texture to the imgui overlay we'll use to recomposite Cemu's original flatscreen rendering
+                    // the image stays in TRANSFER_SRC_OPTIMAL/TRANSFER_DST_OPTIMAL between the copies, and is only restored after the last one
                     if (imguiOverlay && !hudCopied) {
-                        // AMD GPU FIX: ensureSrcLayout transitions to TRANSFER_SRC_OPTIMAL
-                        ensureSrcLayout();
-                        imguiOverlay->DrawHUDLayerAsBackground(commandBuffer, image, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-                        VulkanUtils::DebugPipelineBarrier(commandBuffer);
+                        CopyBatch copyBatch;
+                        imageLayoutTracker.Transition(copyBatch.PreCopy(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+                        imguiOverlay->DrawHUDLayerAsBackground(copyBatch, image, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+                        copyBatch.Record(commandBuffer);
                     }
 
                     if (imguiOverlay && !hudCopied) {
@@ -240,30 +232,27 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
                         imguiOverlay->Update();
                         imguiOverlay->Render();
                         // AMD GPU FIX: DrawAndCopyToImage copies TO the image, needs TRANSFER_DST_OPTIMAL
-                        ensureDstLayout();
+                        BarrierBatch barriers;
+                        imageLayoutTracker.Transition(barriers, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                        barriers.Flush(commandBuffer);
+                        // the transition to TRANSFER_SRC_OPTIMAL below waits for the copy's writes
                         imguiOverlay->DrawAndCopyToImage(commandBuffer, image, frameIdx);
-                        VulkanUtils::DebugPipelineBarrier(commandBuffer);
                     }
 
                     // copy the HUD texture to D3D12 to be presented
                     // only copy the first attempt at capturing when GX2ClearColor is called with this capture index since the game/Cemu clears the 2D layer twice
-                    // AMD GPU FIX: Need to transition from DST back to SRC for copy operation
-                    if (transitionedToDst) {
-                        VulkanUtils::TransitionLayout(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-                        transitionedToDst = false;
-                        transitionedToSrc = true;
-                    } else {
-                        ensureSrcLayout();
-                    }
-                    SharedTexture* texture = layer2D->CopyColorToLayer(commandBuffer, image, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-                    VulkanUtils::DebugPipelineBarrier(commandBuffer);
+                    // AMD GPU FIX: Need to transition from DST back to SRC for copy operation, and then back to the original layout afterwards
+                    CopyBatch copyBatch;
+                    imageLayoutTracker.Transition(copyBatch.PreCopy(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+                    SharedTexture* texture = layer2D->CopyColorToLayer(copyBatch, image, frameIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+                    imageLayoutTracker.Restore(copyBatch.PostCopy());
+                    copyBatch.Record(commandBuffer);
                     renderer->On2DCopied(frameIdx);
                     // AMD GPU FIX: Protect s_activeCopyOperations with mutex
                     {
                         std::lock_guard<std::mutex> lk(s_activeCopyMutex);
                         s_activeCopyOperations.emplace_back(commandBuffer, texture);
                     }
-                    restoreLayout();
                 }
             }
             if (side == OpenXR::EyeSide::RIGHT) {
@@ -274,10 +263,13 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
                     imguiOverlay->Update();
                     imguiOverlay->Render();
                     // AMD GPU FIX: DrawAndCopyToImage copies TO the image, needs TRANSFER_DST_OPTIMAL
-                    ensureDstLayout();
+                    BarrierBatch barriers;
+                    imageLayoutTracker.Transition(barriers, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                    barriers.Flush(commandBuffer);
                     imguiOverlay->DrawAndCopyToImage(commandBuffer, image, frameIdx);
-                    VulkanUtils::DebugPipelineBarrier(commandBuffer);
-                    restoreFromDst();
+                    // the transition back to Cemu's layout waits for the copy's writes
+                    imageLayoutTracker.Restore(barriers);
+                    barriers.Flush(commandBuffer);
                     return;
                 }
 
@@ -287,7 +279,6 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkDeviceDispatch* pDis
                     return pDispatch->CmdClearColorImage(commandBuffer, image, imageLayout, &clearColor, rangeCount, pRanges);
                 }
             }
-            restoreLayout();
         }
         return;
     }
@@ -323,22 +314,23 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkDeviceDispatc
 
         if (side == OpenXR::EyeSide::LEFT || side == OpenXR::EyeSide::RIGHT) {
             // 3D layer - depth texture for 3D rendering
-            if (s_curr3DDepthImage == VK_NULL_HANDLE) {
-                lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
-                    if (it->second.second == VK_FORMAT_D32_SFLOAT) {
-                        s_curr3DDepthImage = it->first;
+            VkImage curr3DDepthImage = VK_NULL_HANDLE;
+            {
+                std::scoped_lock lock(s_curr3DImagesMutex);
+                if (s_curr3DDepthImage == VK_NULL_HANDLE) {
+                    if (const auto imageInfo = s_imageRegistry.Find(image); imageInfo && imageInfo->stereoCandidate && imageInfo->format == VK_FORMAT_D32_SFLOAT) {
+                        s_curr3DDepthImage = image;
                     }
                 }
-                lockImageResolutions.unlock();
+                curr3DDepthImage = s_curr3DDepthImage;
             }
 
-            if (image != s_curr3DDepthImage) {
-                Log::print<RENDERING>("Depth image is not the same as the current 3D depth image! ({} != {})", (void*)image, (void*)s_curr3DDepthImage);
+            if (image != curr3DDepthImage) {
+                Log::print<RENDERING>("Depth image is not the same as the current 3D depth image! ({} != {})", (void*)image, (void*)curr3DDepthImage);
                 return;
             }
 
-            if (VRManager::instance().XR->GetRenderer()->GetFrame(frameCounter).copiedDepth[side]) {
+            if (VRManager::instance().XR->GetRenderer()->Is3DDepthCopied(side, frameCounter)) {
                 // the depth texture has already been copied to the layer
                 Log::print<RENDERING>("A depth texture is already bound for the current frame!");
                 return;
@@ -352,17 +344,19 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkDeviceDispatc
             //
             // checkAssert(layer3D.GetStatus() == Status3D::LEFT_BINDING_COLOR || layer3D.GetStatus() == Status3D::RIGHT_BINDING_COLOR, "3D layer is not in the correct state for capturing depth images!");
 
-            // AMD GPU FIX: Transition to TRANSFER_SRC_OPTIMAL before depth copy
-            VulkanUtils::TransitionLayout(commandBuffer, image, imageLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT);
-            SharedTexture* texture = layer3D->CopyDepthToLayer(side, commandBuffer, image, frameCounter, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            // AMD GPU FIX: Transition to TRANSFER_SRC_OPTIMAL before depth copy, and restore its layout afterwards
+            CopyBatch copyBatch;
+            ImageLayoutTracker imageLayoutTracker(image, VK_IMAGE_ASPECT_DEPTH_BIT, imageLayout);
+            imageLayoutTracker.Transition(copyBatch.PreCopy(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            SharedTexture* texture = layer3D->CopyDepthToLayer(side, commandBuffer, copyBatch, image, frameCounter, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            imageLayoutTracker.Restore(copyBatch.PostCopy());
+            copyBatch.Record(commandBuffer);
             VRManager::instance().XR->GetRenderer()->On3DDepthCopied(side, frameCounter);
             // AMD GPU FIX: Protect s_activeCopyOperations with mutex
-            {
+            if (texture) {
                 std::lock_guard<std::mutex> lk(s_activeCopyMutex);
                 s_activeCopyOperations.emplace_back(commandBuffer, texture);
             }
-            // Restore layout after depth copy
-            VulkanUtils::TransitionLayout(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, imageLayout, VK_IMAGE_ASPECT_DEPTH_BIT);
             return;
         }
     }
@@ -371,26 +365,21 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkDeviceDispatc
     }
 }
 
-static std::unordered_set<VkSemaphore> s_isTimeline;
+static SemaphoreTable s_semaphores;
 
 VkResult VkDeviceOverrides::CreateSemaphore(const vkroots::VkDeviceDispatch* pDispatch, VkDevice device, const VkSemaphoreCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSemaphore* pSemaphore) {
     VkResult res = pDispatch->CreateSemaphore(device, pCreateInfo, pAllocator, pSemaphore);
-    if (res == VK_SUCCESS && vkroots::FindInChain<VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO, const VkSemaphoreCreateInfo>(pCreateInfo->pNext)) {
-        s_isTimeline.emplace(*pSemaphore);
+    if (res == VK_SUCCESS) {
+        s_semaphores.Insert(*pSemaphore, pCreateInfo);
     }
     return res;
 }
 
 void VkDeviceOverrides::DestroySemaphore(const vkroots::VkDeviceDispatch* pDispatch, VkDevice device, VkSemaphore semaphore, const VkAllocationCallbacks* pAllocator) {
-    s_isTimeline.erase(semaphore);
+    s_semaphores.Erase(semaphore);
     return pDispatch->DestroySemaphore(device, semaphore, pAllocator);
 }
 
-inline bool IsTimeline(const VkSemaphore semaphore) {
-    auto it = s_isTimeline.find(semaphore);
-    return it != s_isTimeline.end();
-}
-
 VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkDeviceDispatch* pDispatch, VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence) {
     VkResult result = VK_SUCCESS;
 
@@ -408,14 +397,16 @@ VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkDeviceDispatch* pDispat
     };
     std::vector<ModifiedSubmitInfo_t> modifiedSubmitInfos;
     std::vector<VkSubmitInfo> shadowSubmits;
+    AsyncCopyQueue::SubmitPlans copyPlans;
     size_t activeCopyCount = 0;
+    AsyncCopyQueue* copyQueue = VRManager::instance().VK ? VRManager::instance().VK->GetCopyQueue() : nullptr;
 
     {
         std::lock_guard<std::mutex> lk(s_activeCopyMutex);
         activeCopyCount = s_activeCopyOperations.size();
     }
 
-    if (activeCopyCount == 0) {
+    if (activeCopyCount == 0 && !(copyQueue && copyQueue->HasPendingCopies())) {
         result = pDispatch->QueueSubmit(queue, submitCount, pSubmits, fence);
     }
     else {
@@ -427,6 +418,10 @@ VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkDeviceDispatch* pDispat
         // AMD GPU FIX: Hold mutex for the duration of s_activeCopyOperations access
         std::lock_guard<std::mutex> lk(s_activeCopyMutex);
 
+        if (copyQueue) {
+            copyPlans = copyQueue->PlanSubmits({ pSubmits, submitCount });
+        }
+
         for (uint32_t i = 0; i < submitCount; i++) {
             const VkSubmitInfo& submitInfo = pSubmits[i];
             ModifiedSubmitInfo_t& modifiedSubmitInfo = modifiedSubmitInfos[i];
@@ -463,6 +458,13 @@ VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkDeviceDispatch* pDispat
                     modifiedSubmitInfo.timelineSignalValues[j] = existingTimelineInfo->pSignalSemaphoreValues[j];
                 }
             }
+            else if (submitInfo.waitSemaphoreCount + submitInfo.signalSemaphoreCount > 0) {
+                // without values from the caller, the timeline values we add would be read as 0 for any of the caller's timeline semaphores
+                static std::atomic_bool s_warnedMissingTimelineInfo = false;
+                if (!s_warnedMissingTimelineInfo && s_semaphores.ContainsTimeline({ { submitInfo.pWaitSemaphores, submitInfo.waitSemaphoreCount }, { submitInfo.pSignalSemaphores, submitInfo.signalSemaphoreCount } }) && !s_warnedMissingTimelineInfo.exchange(true)) {
+                    Log::print<WARNING>("QueueSubmit uses timeline semaphores without a VkTimelineSemaphoreSubmitInfo!");
+                }
+            }
 
             // Insert timeline semaphores for active copy operations
             for (uint32_t j = 0; j < submitInfo.commandBufferCount; j++) {
@@ -486,6 +488,20 @@ VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkDeviceDispatch* pDispat
                 }
             }
 
+            // Copies that were staged for the copy queue: wait until the previous copies out of the staging images are done before they're overwritten,
+            // and let the copy queue know once the staging images are filled
+            if (copyQueue) {
+                if (const auto& planned = copyPlans.submits[i]) {
+                    if (planned->plan.waitCopied > 0) {
+                        modifiedSubmitInfo.waitSemaphores.emplace_back(copyQueue->GetCopiedSemaphore());
+                        modifiedSubmitInfo.waitDstStageMasks.emplace_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+                        modifiedSubmitInfo.timelineWaitValues.emplace_back(planned->plan.waitCopied);
+                    }
+                    modifiedSubmitInfo.signalSemaphores.emplace_back(copyQueue->GetStagedSemaphore());
+                    modifiedSubmitInfo.timelineSignalValues.emplace_back(planned->plan.signalStaged);
+                }
+            }
+
             // Update timeline semaphore submit info
             modifiedSubmitInfo.timelineSemaphoreSubmitInfo.waitSemaphoreValueCount = (uint32_t)modifiedSubmitInfo.timelineWaitValues.size();
             modifiedSubmitInfo.timelineSemaphoreSubmitInfo.pWaitSemaphoreValues = modifiedSubmitInfo.timelineWaitValues.data();
@@ -506,6 +522,11 @@ VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkDeviceDispatch* pDispat
             shadowSubmits[i] = modifiedSubmitInfo.submitInfoCopy;
         }
         result = pDispatch->QueueSubmit(queue, submitCount, shadowSubmits.data(), fence);
+
+        // the copies are only taken once Cemu's submit succeeded, and are submitted while the mutex is still held so that they're submitted in the same order as they were planned
+        if (result == VK_SUCCESS && copyQueue) {
+            copyQueue->CommitSubmits(copyPlans);
+        }
     }
 
     if (result != VK_SUCCESS) {
@@ -0,0 +1,121 @@
+#include "hook_profiler.h"
+
+std::mutex HookProfiler::s_mutex;
+std::atomic<uint32_t> HookProfiler::s_slotCount = 0;
+std::vector<std::unique_ptr<HookProfiler::ThreadCounters>> HookProfiler::s_threadCounters;
+std::array<HookProfiler::SlotTotals, HookProfiler::MAX_HOOKS> HookProfiler::s_lastTotals = {};
+std::array<HookProfiler::HookStats, HookProfiler::MAX_HOOKS> HookProfiler::s_stats = {};
+
+uint64_t HookProfiler::s_calibrationTicks = 0;
+std::chrono::steady_clock::time_point HookProfiler::s_calibrationTime = {};
+std::chrono::steady_clock::time_point HookProfiler::s_lastAggregateTime = {};
+double HookProfiler::s_ticksPerMicrosecond = 0.0;
+
+uint32_t HookProfiler::RegisterSlot(const char* name) {
+    std::scoped_lock lock(s_mutex);
+    const uint32_t slot = s_slotCount.load();
+    checkAssert(slot < MAX_HOOKS, "Registered more hooks than the hook profiler has slots for!");
+    s_stats[slot].name = name;
+    s_slotCount.store(slot + 1);
+    return slot;
+}
+
+HookProfiler::ThreadCounters& HookProfiler::GetThreadCounters() {
+    // counters are never freed since Cemu keeps its PPC threads alive for the whole session
+    thread_local ThreadCounters* t_counters = nullptr;
+    if (t_counters == nullptr) {
+        auto counters = std::make_unique<ThreadCounters>();
+        t_counters = counters.get();
+        std::scoped_lock lock(s_mutex);
+        s_threadCounters.emplace_back(std::move(counters));
+    }
+    return *t_counters;
+}
+
+void HookProfiler::Record(uint32_t slot, uint64_t ticks) {
+    if (slot >= MAX_HOOKS)
+        return;
+
+    SlotCounters& counters = GetThreadCounters().slots[slot];
+    counters.calls.store(counters.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    counters.ticks.store(counters.ticks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+    if (ticks > counters.maxTicks.load(std::memory_order_relaxed)) {
+        counters.maxTicks.store(ticks, std::memory_order_relaxed);
+    }
+}
+
+void HookProfiler::Aggregate() {
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t nowTicks = ReadTimestamp();
+
+    std::scoped_lock lock(s_mutex);
+    if (s_calibrationTicks == 0) {
+        s_calibrationTicks = nowTicks;
+        s_calibrationTime = now;
+        s_lastAggregateTime = now;
+        return;
+    }
+
+    // the TSC frequency isn't exposed anywhere, so derive it from the wall clock over the whole session
+    const double elapsedUs = std::chrono::duration<double, std::micro>(now - s_calibrationTime).count();
+    if (elapsedUs > 100000.0) {
+        s_ticksPerMicrosecond = (double)(nowTicks - s_calibrationTicks) / elapsedUs;
+    }
+
+    const double frameSeconds = std::chrono::duration<double>(now - s_lastAggregateTime).count();
+    s_lastAggregateTime = now;
+
+    const uint32_t slotCount = s_slotCount.load();
+    for (uint32_t slot = 0; slot < slotCount; ++slot) {
+        SlotTotals totals = {};
+        uint64_t maxTicks = 0;
+        for (auto& threadCounters : s_threadCounters) {
+            SlotCounters& counters = threadCounters->slots[slot];
+            totals.calls += counters.calls.load(std::memory_order_relaxed);
+            totals.ticks += counters.ticks.load(std::memory_order_relaxed);
+            // note: a call that finishes during the exchange might get its max lost, which is fine for profiling
+            maxTicks = std::max(maxTicks, counters.maxTicks.exchange(0, std::memory_order_relaxed));
+        }
+
+        const uint64_t frameCalls = totals.calls - s_lastTotals[slot].calls;
+        const uint64_t frameTicks = totals.ticks - s_lastTotals[slot].ticks;
+        s_lastTotals[slot] = totals;
+
+        HookStats& stats = s_stats[slot];
+        stats.totalCalls = totals.calls;
+        stats.callsLastFrame = (uint32_t)frameCalls;
+        if (frameSeconds > 0.0) {
+            const float callsPerSecond = (float)((double)frameCalls / frameSeconds);
+            stats.callsPerSecond = stats.callsPerSecond == 0.0f ? callsPerSecond : std::lerp(stats.callsPerSecond, callsPerSecond, 0.1f);
+        }
+        if (s_ticksPerMicrosecond > 0.0) {
+            stats.avgLatencyUs = totals.calls > 0 ? (double)totals.ticks / (double)totals.calls / s_ticksPerMicrosecond : 0.0;
+            stats.maxLatencyUs = (double)maxTicks / s_ticksPerMicrosecond;
+            stats.frameTimeUs = (double)frameTicks / s_ticksPerMicrosecond;
+        }
+    }
+}
+
+void HookProfiler::GetStats(std::vector<HookStats>& stats) {
+    std::scoped_lock lock(s_mutex);
+    stats.assign(s_stats.begin(), s_stats.begin() + s_slotCount.load());
+}
+
+bool HookProfiler::DumpToCSV(const std::filesystem::path& path) {
+    std::vector<HookStats> stats;
+    GetStats(stats);
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        Log::print<WARNING>("Failed to open {} to dump hook statistics", path.string());
+        return false;
+    }
+
+    file << "hook,total_calls,calls_last_frame,calls_per_second,avg_latency_us,max_latency_us,frame_time_us\n";
+    for (const HookStats& hook : stats) {
+        file << std::format("{},{},{},{:.2f},{:.3f},{:.3f},{:.3f}\n", hook.name, hook.totalCalls, hook.callsLastFrame, hook.callsPerSecond, hook.avgLatencyUs, hook.maxLatencyUs, hook.frameTimeUs);
+    }
+
+    Log::print<INFO>("Dumped statistics of {} hooks to {}", stats.size(), path.string());
+    return true;
+}
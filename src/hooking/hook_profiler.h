@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+struct PPCInterpreter_t;
+
+// Counts the calls and measures the latency of every HLE hook that's registered through it.
+// Each hook gets a fixed slot when it's registered, calls are recorded into counters owned by the calling thread, and those get summed up once per frame by Aggregate().
+class HookProfiler {
+public:
+    static constexpr uint32_t MAX_HOOKS = 64;
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+    using HookFunc = void (*)(PPCInterpreter_t*);
+
+    struct HookStats {
+        const char* name = nullptr;
+        uint64_t totalCalls = 0;
+        uint32_t callsLastFrame = 0;
+        float callsPerSecond = 0.0f;
+        double avgLatencyUs = 0.0;   // average of a single call over the whole session
+        double maxLatencyUs = 0.0;   // slowest single call during the last frame
+        double frameTimeUs = 0.0;    // total time spent in the hook during the last frame
+    };
+
+    // returns the function that should be registered with Cemu instead of the hook itself
+    template <HookFunc Hook>
+    static HookFunc Wrap(const char* name) {
+        if (s_slot<Hook> == INVALID_SLOT) {
+            s_slot<Hook> = RegisterSlot(name);
+        }
+        return &Wrapper<Hook>;
+    }
+
+    static uint32_t RegisterSlot(const char* name);
+    static void Record(uint32_t slot, uint64_t ticks);
+
+    static void Aggregate();
+    static void GetStats(std::vector<HookStats>& stats);
+    static bool DumpToCSV(const std::filesystem::path& path);
+
+    static uint64_t ReadTimestamp() { return __rdtsc(); }
+
+private:
+    template <HookFunc Hook>
+    static void Wrapper(PPCInterpreter_t* hCPU) {
+        const uint64_t start = ReadTimestamp();
+        Hook(hCPU);
+        Record(s_slot<Hook>, ReadTimestamp() - start);
+    }
+
+    template <HookFunc Hook>
+    static inline uint32_t s_slot = INVALID_SLOT;
+
+    // only the owning thread writes to these, so relaxed loads and stores are enough
+    struct SlotCounters {
+        std::atomic<uint64_t> calls = 0;
+        std::atomic<uint64_t> ticks = 0;
+        std::atomic<uint64_t> maxTicks = 0;
+    };
+    struct ThreadCounters {
+        std::array<SlotCounters, MAX_HOOKS> slots;
+    };
+    static ThreadCounters& GetThreadCounters();
+
+    struct SlotTotals {
+        uint64_t calls = 0;
+        uint64_t ticks = 0;
+    };
+
+    static std::mutex s_mutex;
+    static std::atomic<uint32_t> s_slotCount;
+    static std::vector<std::unique_ptr<ThreadCounters>> s_threadCounters;
+    static std::array<SlotTotals, MAX_HOOKS> s_lastTotals;
+    static std::array<HookStats, MAX_HOOKS> s_stats;
+
+    // used to convert TSC ticks to time
+    static uint64_t s_calibrationTicks;
+    static std::chrono::steady_clock::time_point s_calibrationTime;
+    static std::chrono::steady_clock::time_point s_lastAggregateTime;
+    static double s_ticksPerMicrosecond;
+};
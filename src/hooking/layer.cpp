@@ -611,6 +611,36 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkInstanceDis
         pDispatch->GetPhysicalDeviceQueueFamilyProperties(gpu, &queueFamilyCount, queueFamilies.data());
     }
 
+    // add a queue without graphics support for the eye copies, if Cemu leaves one unused
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos(pCreateInfo->pQueueCreateInfos, pCreateInfo->pQueueCreateInfos + pCreateInfo->queueCreateInfoCount);
+    std::vector<float> queuePriorities;
+    const auto graphicsQueueInfo = std::ranges::find_if(queueCreateInfos, [&queueFamilies](const VkDeviceQueueCreateInfo& info) {
+        return info.queueFamilyIndex < queueFamilies.size() && (queueFamilies[info.queueFamilyIndex].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+    });
+    const uint32_t graphicsFamilyIndex = graphicsQueueInfo != queueCreateInfos.end() ? graphicsQueueInfo->queueFamilyIndex : 0;
+    const auto copyQueue = graphicsQueueInfo != queueCreateInfos.end() ? CopySchedule::SelectQueue(queueFamilies, queueCreateInfos) : std::nullopt;
+    if (copyQueue && copyQueue->addsQueueCreateInfo) {
+        queuePriorities = { 1.0f };
+        queueCreateInfos.emplace_back(VkDeviceQueueCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = copyQueue->familyIndex,
+            .queueCount = 1,
+            .pQueuePriorities = queuePriorities.data()
+        });
+    }
+    else if (copyQueue) {
+        auto& queueInfo = *std::ranges::find(queueCreateInfos, copyQueue->familyIndex, &VkDeviceQueueCreateInfo::queueFamilyIndex);
+        queuePriorities.assign(queueInfo.pQueuePriorities, queueInfo.pQueuePriorities + queueInfo.queueCount);
+        queuePriorities.emplace_back(1.0f);
+        queueInfo.queueCount++;
+        queueInfo.pQueuePriorities = queuePriorities.data();
+    }
+    else {
+        Log::print<INFO>("No separate queue is available for the eye copies, they'll be recorded into Cemu's command buffers instead");
+    }
+    modifiedCreateInfo.queueCreateInfoCount = (uint32_t)queueCreateInfos.size();
+    modifiedCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
+
     Log::print<INFO>("Creating Vulkan device with {} queue infos", modifiedCreateInfo.queueCreateInfoCount);
     for (uint32_t i = 0; i < modifiedCreateInfo.queueCreateInfoCount; i++) {
         const auto& qci = modifiedCreateInfo.pQueueCreateInfos[i];
@@ -628,6 +658,10 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkInstanceDis
         return result;
     }
 
+    if (copyQueue) {
+        AsyncCopyQueue::ReserveQueue(graphicsFamilyIndex, *copyQueue);
+    }
+
     // Initialize VRManager late if neither vkEnumeratePhysicalDevices and vkGetPhysicalDeviceProperties were called and used to filter the device
     if (!VRManager::instance().VK) {
         Log::print<WARNING>("Wasn't able to filter OpenXR-compatible devices for this instance!");
@@ -639,6 +673,9 @@ VkResult VRLayer::VkInstanceOverrides::CreateDevice(const vkroots::VkInstanceDis
 }
 
 void VRLayer::VkDeviceOverrides::DestroyDevice(const vkroots::VkDeviceDispatch* pDispatch, VkDevice device, const VkAllocationCallbacks* pAllocator) {
+    if (VRManager::instance().VK && VRManager::instance().VK->GetDevice() == device) {
+        VRManager::instance().VK->DestroyCopyQueue();
+    }
     return pDispatch->DestroyDevice(device, pAllocator);
 }
 
@@ -293,7 +293,8 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
     if (!inputs.inGame.in_game || !inputs.inGame.pose[side].isActive)
         return;
 
-    const auto& pose = inputs.inGame.poseLocation[side];
+    // the smoothed pose keeps tracking jitter out of the arm IK
+    const auto& pose = inputs.inGame.filteredPoseLocation[side];
     glm::fvec3 controllerPos = glm::fvec3();
     glm::fquat controllerRot = glm::identity<glm::fquat>();
     if (pose.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
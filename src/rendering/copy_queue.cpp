@@ -0,0 +1,258 @@
+#include "copy_queue.h"
+#include "instance.h"
+
+
+void AsyncCopyQueue::ReserveQueue(uint32_t graphicsFamilyIndex, const CopySchedule::QueueSelection& selection) {
+    s_reservedQueue = ReservedQueue{ graphicsFamilyIndex, selection.familyIndex, selection.queueIndex };
+}
+
+AsyncCopyQueue::AsyncCopyQueue(VkDevice device, const vkroots::VkDeviceDispatch* dispatch): m_device(device), m_dispatch(dispatch) {
+    checkAssert(s_reservedQueue.has_value(), "No queue was reserved for the eye copies!");
+    m_dispatch->GetDeviceQueue(m_device, s_reservedQueue->familyIndex, s_reservedQueue->queueIndex, &m_queue);
+
+    VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = s_reservedQueue->familyIndex;
+    checkVkResult(m_dispatch->CreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool), "Failed to create command pool for the copy queue!");
+
+    VkSemaphoreTypeCreateInfo timelineCreateInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    timelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineCreateInfo.initialValue = 0;
+    VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    semaphoreInfo.pNext = &timelineCreateInfo;
+    checkVkResult(m_dispatch->CreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_stagedSemaphore), "Failed to create staged timeline semaphore!");
+    checkVkResult(m_dispatch->CreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_copiedSemaphore), "Failed to create copied timeline semaphore!");
+
+    Log::print<INFO>("Eye copies are submitted to queue {} of queue family {}", s_reservedQueue->queueIndex, s_reservedQueue->familyIndex);
+}
+
+AsyncCopyQueue::~AsyncCopyQueue() {
+    if (m_queue != VK_NULL_HANDLE) {
+        m_dispatch->QueueWaitIdle(m_queue);
+    }
+    for (StagingImage& staging : m_stagingImages) {
+        DestroyStagingImage(staging);
+    }
+    for (const CommandBuffer& commandBuffer : m_commandBuffers) {
+        vkroots::tables::CommandBufferDispatches.remove(commandBuffer.cmdBuffer);
+        m_dispatch->FreeCommandBuffers(m_device, m_commandPool, 1, &commandBuffer.cmdBuffer);
+    }
+    m_dispatch->DestroyCommandPool(m_device, m_commandPool, nullptr);
+    m_dispatch->DestroySemaphore(m_device, m_stagedSemaphore, nullptr);
+    m_dispatch->DestroySemaphore(m_device, m_copiedSemaphore, nullptr);
+}
+
+void AsyncCopyQueue::Stage(VkCommandBuffer cmdBuffer, CopyBatch& batch, VkImage srcImage, SharedTexture* texture, uint32_t side, uint32_t frameIdx) {
+    std::lock_guard lock(m_mutex);
+    const uint32_t slot = GetStagingSlot({ side, frameIdx, texture->GetFormat() }, texture);
+    const StagingImage& staging = m_stagingImages[slot];
+    const VkImageAspectFlags aspectMask = texture->GetAspectMask();
+
+    // the previous contents don't need to be kept, and the copy queue's read of them is ordered through the copied timeline
+    batch.PreCopy().Transition(staging.image, aspectMask, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    batch.PostCopy().Transition(staging.image, aspectMask, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    batch.AddCopy({
+        .srcImage = srcImage,
+        .dstImage = staging.image,
+        .region = {
+            .srcSubresource = { aspectMask, 0, 0, 1 },
+            .srcOffset = { 0, 0, 0 },
+            .dstSubresource = { aspectMask, 0, 0, 1 },
+            .dstOffset = { 0, 0, 0 },
+            .extent = { staging.width, staging.height, 1 }
+        },
+        .timestampPool = VK_NULL_HANDLE
+    });
+
+    m_pending.emplace_back(PendingCopy{ cmdBuffer, slot, texture });
+    m_pendingCount.store(m_pending.size(), std::memory_order_relaxed);
+}
+
+AsyncCopyQueue::SubmitPlans AsyncCopyQueue::PlanSubmits(std::span<const VkSubmitInfo> submits) {
+    std::lock_guard lock(m_mutex);
+    SubmitPlans plans = { .submits = {}, .cmdBuffers = {}, .planner = m_planner };
+    for (const VkSubmitInfo& submit : submits) {
+        const std::span<const VkCommandBuffer> cmdBuffers(submit.pCommandBuffers, submit.commandBufferCount);
+        PlannedSubmit planned;
+        std::vector<uint32_t> slots;
+        for (const PendingCopy& pending : m_pending) {
+            if (std::ranges::find(cmdBuffers, pending.cemuCmdBuffer) == cmdBuffers.end())
+                continue;
+            planned.copies.emplace_back(pending.slot, pending.texture);
+            slots.emplace_back(pending.slot);
+        }
+        if (planned.copies.empty()) {
+            plans.submits.emplace_back(std::nullopt);
+            continue;
+        }
+        plans.cmdBuffers.insert(plans.cmdBuffers.end(), cmdBuffers.begin(), cmdBuffers.end());
+        planned.plan = plans.planner.PlanSubmit(slots);
+        plans.submits.emplace_back(std::move(planned));
+    }
+    return plans;
+}
+
+void AsyncCopyQueue::CommitSubmits(const SubmitPlans& plans) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_planner = plans.planner;
+        std::erase_if(m_pending, [&](const PendingCopy& pending) { return std::ranges::find(plans.cmdBuffers, pending.cemuCmdBuffer) != plans.cmdBuffers.end(); });
+        m_pendingCount.store(m_pending.size(), std::memory_order_relaxed);
+    }
+
+    for (const auto& planned : plans.submits) {
+        if (planned)
+            SubmitCopies(*planned);
+    }
+}
+
+void AsyncCopyQueue::SubmitCopies(const PlannedSubmit& planned) {
+    std::lock_guard lock(m_mutex);
+    VkCommandBuffer cmdBuffer = AcquireCommandBuffer(planned.plan.signalCopied);
+
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    checkVkResult(m_dispatch->BeginCommandBuffer(cmdBuffer, &beginInfo), "Failed to begin command buffer for the copy queue!");
+
+    // the staging images stay in TRANSFER_SRC_OPTIMAL, all copies share the barriers of the shared textures
+    CopyBatch batch;
+    for (const auto& [slot, texture] : planned.copies) {
+        texture->CopyFromVkImage(batch, m_stagingImages[slot].image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    }
+    batch.Record(cmdBuffer);
+    checkVkResult(m_dispatch->EndCommandBuffer(cmdBuffer), "Failed to end command buffer for the copy queue!");
+
+    std::vector<VkSemaphore> waitSemaphores = { m_stagedSemaphore };
+    std::vector<uint64_t> waitValues = { planned.plan.signalStaged };
+    std::vector<VkPipelineStageFlags> waitStages = { VK_PIPELINE_STAGE_TRANSFER_BIT };
+    std::vector<VkSemaphore> signalSemaphores = { m_copiedSemaphore };
+    std::vector<uint64_t> signalValues = { planned.plan.signalCopied };
+    for (const auto& [slot, texture] : planned.copies) {
+        // Wait for D3D12/XR to finish with the previous shared texture render
+        const uint64_t waitValue = texture->GetVulkanWaitValue();
+        waitSemaphores.emplace_back(texture->GetSemaphoreForWait(waitValue));
+        waitValues.emplace_back(waitValue);
+        waitStages.emplace_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        // Signal to D3D12/XR rendering that the shared texture can be rendered to VR headset
+        const uint64_t signalValue = texture->GetVulkanSignalValue();
+        signalSemaphores.emplace_back(texture->GetSemaphoreForSignal(signalValue));
+        signalValues.emplace_back(signalValue);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    timelineInfo.waitSemaphoreValueCount = (uint32_t)waitValues.size();
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = (uint32_t)signalValues.size();
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmdBuffer;
+    submitInfo.signalSemaphoreCount = (uint32_t)signalSemaphores.size();
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+    checkVkResult(m_dispatch->QueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE), "Failed to submit the eye copies to the copy queue!");
+}
+
+uint32_t AsyncCopyQueue::GetStagingSlot(const StagingKey& key, SharedTexture* texture) {
+    DestroyRetiredStagingImages();
+
+    const auto it = std::ranges::find_if(m_stagingImages, [&](const StagingImage& staging) { return staging.image != VK_NULL_HANDLE && !staging.retired && staging.key == key; });
+    if (it != m_stagingImages.end()) {
+        if (it->width == texture->GetWidth() && it->height == texture->GetHeight())
+            return (uint32_t)std::distance(m_stagingImages.begin(), it);
+
+        // the resolution changed, but command buffers that haven't been submitted yet can still copy into the old staging image
+        it->retired = true;
+    }
+
+    // reuse a slot whose staging image was destroyed, its last copied value has already been reached
+    auto freeIt = std::ranges::find(m_stagingImages, VK_NULL_HANDLE, &StagingImage::image);
+    if (freeIt == m_stagingImages.end()) {
+        freeIt = m_stagingImages.insert(m_stagingImages.end(), StagingImage{});
+    }
+    CreateStagingImage(*freeIt, key, texture);
+    return (uint32_t)std::distance(m_stagingImages.begin(), freeIt);
+}
+
+void AsyncCopyQueue::DestroyRetiredStagingImages() {
+    uint64_t completedValue = 0;
+    m_dispatch->GetSemaphoreCounterValueKHR(m_device, m_copiedSemaphore, &completedValue);
+    for (uint32_t slot = 0; slot < m_stagingImages.size(); slot++) {
+        StagingImage& staging = m_stagingImages[slot];
+        if (!staging.retired || staging.image == VK_NULL_HANDLE)
+            continue;
+        // still staged by a command buffer that wasn't submitted yet, or still being copied out of
+        if (std::ranges::find(m_pending, slot, &PendingCopy::slot) != m_pending.end() || m_planner.GetLastCopiedValue(slot) > completedValue)
+            continue;
+        DestroyStagingImage(staging);
+    }
+}
+
+void AsyncCopyQueue::CreateStagingImage(StagingImage& staging, const StagingKey& key, SharedTexture* texture) {
+    // shared between both queue families so that no ownership transfers are needed
+    const uint32_t queueFamilies[] = { s_reservedQueue->graphicsFamilyIndex, s_reservedQueue->familyIndex };
+
+    VkImageCreateInfo imageCreateInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = texture->GetFormat();
+    imageCreateInfo.extent = { texture->GetWidth(), texture->GetHeight(), 1 };
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    imageCreateInfo.queueFamilyIndexCount = (uint32_t)std::size(queueFamilies);
+    imageCreateInfo.pQueueFamilyIndices = queueFamilies;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    checkVkResult(m_dispatch->CreateImage(m_device, &imageCreateInfo, nullptr, &staging.image), "Failed to create staging image for the copy queue!");
+
+    VkMemoryRequirements memRequirements;
+    m_dispatch->GetImageMemoryRequirements(m_device, staging.image, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = VRManager::instance().VK->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    checkVkResult(m_dispatch->AllocateMemory(m_device, &allocInfo, nullptr, &staging.memory), "Failed to allocate memory for staging image!");
+    checkVkResult(m_dispatch->BindImageMemory(m_device, staging.image, staging.memory, 0), "Failed to bind memory to staging image!");
+
+    staging.key = key;
+    staging.width = texture->GetWidth();
+    staging.height = texture->GetHeight();
+    staging.retired = false;
+}
+
+void AsyncCopyQueue::DestroyStagingImage(StagingImage& staging) {
+    if (staging.image != VK_NULL_HANDLE)
+        m_dispatch->DestroyImage(m_device, staging.image, nullptr);
+    if (staging.memory != VK_NULL_HANDLE)
+        m_dispatch->FreeMemory(m_device, staging.memory, nullptr);
+    staging = {};
+}
+
+VkCommandBuffer AsyncCopyQueue::AcquireCommandBuffer(uint64_t copiedValue) {
+    uint64_t completedValue = 0;
+    m_dispatch->GetSemaphoreCounterValueKHR(m_device, m_copiedSemaphore, &completedValue);
+    for (CommandBuffer& commandBuffer : m_commandBuffers) {
+        if (commandBuffer.copiedValue <= completedValue) {
+            commandBuffer.copiedValue = copiedValue;
+            return commandBuffer.cmdBuffer;
+        }
+    }
+
+    VkCommandBufferAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+    checkVkResult(m_dispatch->AllocateCommandBuffers(m_device, &allocInfo, &cmdBuffer), "Failed to allocate command buffer for the copy queue!");
+    // register it like vkroots does for Cemu's command buffers, since the barrier and copy helpers look up the dispatch through the command buffer
+    vkroots::tables::CommandBufferDispatches.insert(cmdBuffer, vkroots::tables::RawPointer(m_dispatch));
+    m_commandBuffers.emplace_back(CommandBuffer{ cmdBuffer, copiedValue });
+    return cmdBuffer;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "texture.h"
+#include "utils/copy_schedule.h"
+
+#include <mutex>
+
+// Moves the copies of the eye textures into the shared textures off Cemu's queue.
+// Cemu's command buffer only copies its image into a staging image (since Cemu keeps rendering into its image afterwards),
+// after which the copy into the shared texture is submitted to a separate queue. That way Cemu's submit no longer has to wait
+// for the D3D12 side to be done with the shared texture, and the copy overlaps with the rendering of the next eye.
+class AsyncCopyQueue {
+public:
+    // called from vkCreateDevice once the queue for the copies has been added to the device
+    static void ReserveQueue(uint32_t graphicsFamilyIndex, const CopySchedule::QueueSelection& selection);
+    static bool IsQueueReserved() { return s_reservedQueue.has_value(); }
+
+    AsyncCopyQueue(VkDevice device, const vkroots::VkDeviceDispatch* dispatch);
+    ~AsyncCopyQueue();
+
+    // Records the copy of srcImage (which has to be in TRANSFER_SRC_OPTIMAL) into the texture's staging image into Cemu's command buffer.
+    // The texture is copied on the copy queue after the command buffer has been submitted. Each eye and frame index has its own staging image per format.
+    void Stage(VkCommandBuffer cmdBuffer, CopyBatch& batch, VkImage srcImage, SharedTexture* texture, uint32_t side, uint32_t frameIdx);
+    bool HasPendingCopies() const { return m_pendingCount.load(std::memory_order_relaxed) > 0; }
+
+    struct PlannedSubmit {
+        CopySchedule::TimelinePlanner::SubmitPlan plan;
+        std::vector<std::pair<uint32_t, SharedTexture*>> copies; // staging slot and destination
+    };
+    struct SubmitPlans {
+        std::vector<std::optional<PlannedSubmit>> submits; // one for each VkSubmitInfo
+        std::vector<VkCommandBuffer> cmdBuffers; // whose staged copies were planned
+        CopySchedule::TimelinePlanner planner; // the timelines after all of the planned submits
+    };
+    // Plans the staged copies of the command buffers that are about to be submitted. Each of Cemu's submits with copies has to wait for
+    // GetCopiedSemaphore() to reach plan.waitCopied (if not 0) and signal GetStagedSemaphore() with plan.signalStaged.
+    // Nothing is taken yet, so a submit that fails leaves the staged copies and the timelines as they were.
+    SubmitPlans PlanSubmits(std::span<const VkSubmitInfo> submits);
+    // takes the planned copies and submits them once Cemu's submit succeeded, has to be called under the same lock as PlanSubmits() and the submit
+    void CommitSubmits(const SubmitPlans& plans);
+
+    VkSemaphore GetStagedSemaphore() const { return m_stagedSemaphore; }
+    VkSemaphore GetCopiedSemaphore() const { return m_copiedSemaphore; }
+
+private:
+    struct StagingKey {
+        uint32_t side;
+        uint32_t frameIdx;
+        VkFormat format;
+
+        bool operator==(const StagingKey&) const = default;
+    };
+    struct StagingImage {
+        StagingKey key = {};
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        bool retired = false; // replaced after a resolution change, destroyed once its last copy is done
+    };
+    struct CommandBuffer {
+        VkCommandBuffer cmdBuffer;
+        uint64_t copiedValue; // can be reused once the copied timeline reaches this value
+    };
+    struct PendingCopy {
+        VkCommandBuffer cemuCmdBuffer;
+        uint32_t slot;
+        SharedTexture* texture;
+    };
+
+    uint32_t GetStagingSlot(const StagingKey& key, SharedTexture* texture);
+    void CreateStagingImage(StagingImage& staging, const StagingKey& key, SharedTexture* texture);
+    void DestroyStagingImage(StagingImage& staging);
+    void DestroyRetiredStagingImages();
+    void SubmitCopies(const PlannedSubmit& planned);
+    VkCommandBuffer AcquireCommandBuffer(uint64_t copiedValue);
+
+    struct ReservedQueue {
+        uint32_t graphicsFamilyIndex;
+        uint32_t familyIndex;
+        uint32_t queueIndex;
+    };
+    static inline std::optional<ReservedQueue> s_reservedQueue;
+
+    VkDevice m_device;
+    const vkroots::VkDeviceDispatch* m_dispatch;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    VkSemaphore m_stagedSemaphore = VK_NULL_HANDLE;
+    VkSemaphore m_copiedSemaphore = VK_NULL_HANDLE;
+
+    std::mutex m_mutex;
+    CopySchedule::TimelinePlanner m_planner;
+    std::vector<StagingImage> m_stagingImages;
+    std::vector<CommandBuffer> m_commandBuffers;
+    std::vector<PendingCopy> m_pending;
+    std::atomic<size_t> m_pendingCount = 0;
+};
@@ -100,17 +100,18 @@ RND_D3D12::PresentPipeline<depth>::PresentPipeline(RND_Renderer* pRenderer) {
                 D3D12_SHADER_VISIBILITY_PIXEL
             },
             {
-                D3D12_ROOT_PARAMETER_TYPE_CBV,
-                {
-                    1,
-                    0
+                .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+                .Constants = {
+                    .ShaderRegister = 1,
+                    .RegisterSpace = 0,
+                    .Num32BitValues = sizeof(presentSettings) / sizeof(uint32_t)
                 },
-                D3D12_SHADER_VISIBILITY_ALL
+                .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
             }
         };
         // clang-format on
 
-        D3D12_STATIC_SAMPLER_DESC textureSampler = {
+        D3D12_STATIC_SAMPLER_DESC pointSampler = {
             .Filter = D3D12_FILTER_MIN_MAG_MIP_POINT,
             .AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP,
             .AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP,
@@ -125,12 +126,16 @@ RND_D3D12::PresentPipeline<depth>::PresentPipeline(RND_Renderer* pRenderer) {
             .RegisterSpace = 0,
             .ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL
         };
+        D3D12_STATIC_SAMPLER_DESC linearSampler = pointSampler;
+        linearSampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+        linearSampler.ShaderRegister = 1;
+        D3D12_STATIC_SAMPLER_DESC samplers[] = { pointSampler, linearSampler };
 
         D3D12_ROOT_SIGNATURE_DESC rootSigDesc = {
             .NumParameters = (UINT)std::size(rootParams),
             .pParameters = rootParams,
-            .NumStaticSamplers = 1,
-            .pStaticSamplers = &textureSampler,
+            .NumStaticSamplers = (UINT)std::size(samplers),
+            .pStaticSamplers = samplers,
             .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT
         };
 
@@ -205,6 +210,11 @@ void RND_D3D12::PresentPipeline<depth>::BindAttachment(uint32_t attachmentIdx, I
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Texture2D.MipLevels = 1;
     VRManager::instance().D3D12->GetDevice()->CreateShaderResourceView(srcTexture, &srvDesc, m_attachmentHandles[attachmentIdx]);
+
+    if (attachmentIdx == 0) {
+        m_sourceWidth = (uint32_t)srcTexture->GetDesc().Width;
+        m_sourceHeight = (uint32_t)srcTexture->GetDesc().Height;
+    }
 }
 
 template <bool depth>
@@ -234,35 +244,6 @@ void RND_D3D12::PresentPipeline<depth>::BindDepthTarget(ID3D12Resource* dstTextu
     }
 }
 
-template <bool depth>
-void RND_D3D12::PresentPipeline<depth>::BindSettings(float screenWidth, float screenHeight) {
-    ComPtr<ID3D12Resource> newSettingsStaging;
-    ComPtr<ID3D12CommandAllocator> newSettingsAllocator;
-    {
-        ID3D12Device* device = VRManager::instance().D3D12->GetDevice();
-        ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetCommandQueue();
-        device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&newSettingsAllocator));
-        RND_D3D12::CommandContext<true> uploadBufferContext(device, queue, newSettingsAllocator.Get(), [this, device, &newSettingsStaging, screenWidth, screenHeight](RND_D3D12::CommandContext<true>* context) {
-            m_settingsBuffer = D3D12Utils::CreateConstantBuffer(device, D3D12_HEAP_TYPE_DEFAULT, sizeof(presentSettings));
-
-            newSettingsStaging = D3D12Utils::CreateConstantBuffer(device, D3D12_HEAP_TYPE_UPLOAD, sizeof(presentSettings));
-            void* data;
-            const D3D12_RANGE readRange = { .Begin = 0, .End = 0 };
-            checkHResult(newSettingsStaging->Map(0, &readRange, &data), "Failed to map memory for screen indices buffer!");
-            presentSettings settings = {
-                .renderWidth = screenWidth,
-                .renderHeight = screenHeight,
-                .swapchainWidth = screenWidth,
-                .swapchainHeight = screenHeight,
-            };
-            memcpy(data, &settings, sizeof(presentSettings));
-            newSettingsStaging->Unmap(0, nullptr);
-
-            context->GetRecordList()->CopyBufferRegion(m_settingsBuffer.Get(), 0, newSettingsStaging.Get(), 0, sizeof(presentSettings));
-        });
-    }
-}
-
 template <bool depth>
 void RND_D3D12::PresentPipeline<depth>::RecreatePipeline() {
     // AMD GPU FIX: Don't declare SV_InstanceID/SV_VertexID in the input layout.
@@ -345,16 +326,29 @@ void RND_D3D12::PresentPipeline<depth>::Render(ID3D12GraphicsCommandList* cmdLis
     cmdList->SetPipelineState(m_pipelineState.Get());
     cmdList->SetGraphicsRootSignature(m_signature.Get());
 
+    const uint32_t viewportWidth = (uint32_t)swapchain->GetDesc().Width;
+    const uint32_t viewportHeight = (uint32_t)swapchain->GetDesc().Height;
+
     // set framebuffer
-    D3D12_VIEWPORT viewportSize = { 0.0f, 0.0f, (float)swapchain->GetDesc().Width, (float)swapchain->GetDesc().Height, 0.0f, 1.0f };
+    D3D12_VIEWPORT viewportSize = { 0.0f, 0.0f, (float)viewportWidth, (float)viewportHeight, 0.0f, 1.0f };
     cmdList->RSSetViewports(1, &viewportSize);
 
-    D3D12_RECT scissorRect = { 0, 0, (LONG)swapchain->GetDesc().Width, (LONG)swapchain->GetDesc().Height };
+    D3D12_RECT scissorRect = { 0, 0, (LONG)viewportWidth, (LONG)viewportHeight };
     cmdList->RSSetScissorRects(1, &scissorRect);
 
-    // set settings
-    checkAssert(m_settingsBuffer != nullptr, "Failed to present texture since graphics pipeline hasn't bound some settings yet!");
-    cmdList->SetGraphicsRootConstantBufferView(1, m_settingsBuffer->GetGPUVirtualAddress());
+    // set settings, these are pushed as root constants since the filter can change every frame
+    const uint32_t sourceWidth = m_sourceWidth != 0 ? m_sourceWidth : viewportWidth;
+    const uint32_t sourceHeight = m_sourceHeight != 0 ? m_sourceHeight : viewportHeight;
+    const PresentFilter filter = m_filter != PresentFilter::AUTO ? m_filter : SelectPresentFilter(sourceWidth, sourceHeight, viewportWidth, viewportHeight);
+    m_lastFilter = filter;
+    presentSettings settings = {
+        .renderWidth = (float)sourceWidth,
+        .renderHeight = (float)sourceHeight,
+        .swapchainWidth = (float)viewportWidth,
+        .swapchainHeight = (float)viewportHeight,
+        .filter = (uint32_t)filter,
+    };
+    cmdList->SetGraphicsRoot32BitConstants(1, sizeof(presentSettings) / sizeof(uint32_t), &settings, 0);
 
     // set shared texture
     ID3D12DescriptorHeap* heaps[] = { m_attachmentHeap.Get() };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "openxr.h"
+#include "utils/present_kernels.h"
 
 class RND_D3D12 {
     friend class RND_Renderer;
@@ -32,6 +33,13 @@ public:
 
     ID3D12CommandAllocator* GetFrameAllocator() { return m_allocator.Get(); };
 
+    using PresentFilter = PresentKernels::Filter;
+
+    static PresentFilter SelectPresentFilter(uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight) {
+        return PresentKernels::SelectFilter(srcWidth, srcHeight, dstWidth, dstHeight);
+    }
+    static const char* GetPresentFilterName(PresentFilter filter) { return PresentKernels::GetFilterName(filter); }
+
     // todo: extract most to a base pipeline class if other pipelines are needed
     template <bool depth>
     class PresentPipeline {
@@ -44,7 +52,9 @@ public:
         void BindAttachment(uint32_t attachmentIdx, ID3D12Resource* srcTexture, DXGI_FORMAT overwriteFormat = DXGI_FORMAT_UNKNOWN);
         void BindTarget(uint32_t targetIdx, ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat = DXGI_FORMAT_UNKNOWN);
         void BindDepthTarget(ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat);
-        void BindSettings(float screenWidth, float screenHeight);
+        // AUTO picks the filter every frame based on the size of attachment 0 and the viewport
+        void SetFilter(PresentFilter filter) { m_filter = filter; }
+        PresentFilter GetLastFilter() const { return m_lastFilter; }
         void Render(ID3D12GraphicsCommandList* commandList, ID3D12Resource* swapchain);
 
     private:
@@ -56,7 +66,10 @@ public:
         ComPtr<ID3D12Resource> m_screenIndicesBuffer;
         D3D12_INDEX_BUFFER_VIEW m_screenIndicesView = {};
 
-        ComPtr<ID3D12Resource> m_settingsBuffer;
+        uint32_t m_sourceWidth = 0;
+        uint32_t m_sourceHeight = 0;
+        PresentFilter m_filter = PresentFilter::AUTO;
+        std::atomic<PresentFilter> m_lastFilter = PresentFilter::POINT;
 
         ComPtr<ID3D12RootSignature> m_signature;
         ComPtr<ID3D12PipelineState> m_pipelineState;
@@ -0,0 +1,114 @@
+#include "depth_readback.h"
+#include "instance.h"
+
+
+DepthReadback::DepthReadback(uint32_t width, uint32_t height): m_width(width), m_height(height) {
+    const auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
+    const VkDevice device = VRManager::instance().VK->GetDevice();
+
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size = GetSlotOffset(SLOT_COUNT);
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    checkVkResult(dispatch->CreateBuffer(device, &bufferInfo, nullptr, &m_buffer), "Failed to create depth readback buffer!");
+
+    VkMemoryRequirements memRequirements;
+    dispatch->GetBufferMemoryRequirements(device, m_buffer, &memRequirements);
+
+    // cached memory, since the CPU reads every value
+    // not every driver has a type that's both cached and coherent, a cached one is still preferred over an uncached one since reading uncached memory is very slow
+    RND_Vulkan* vk = VRManager::instance().VK.get();
+    std::optional<uint32_t> memoryType = vk->TryFindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    if (!memoryType) {
+        memoryType = vk->TryFindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    }
+    if (!memoryType) {
+        Log::print<WARNING>("DepthReadback: No cached host memory available, reading the depth back from uncached memory");
+        memoryType = vk->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+    m_coherent = (vk->GetMemoryTypeProperties(memoryType.value()) & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+    VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryType.value();
+    checkVkResult(dispatch->AllocateMemory(device, &allocInfo, nullptr, &m_memory), "Failed to allocate memory for depth readback buffer!");
+    checkVkResult(dispatch->BindBufferMemory(device, m_buffer, m_memory, 0), "Failed to bind memory to depth readback buffer!");
+    checkVkResult(dispatch->MapMemory(device, m_memory, 0, VK_WHOLE_SIZE, 0, (void**)&m_mapped), "Failed to map depth readback buffer!");
+
+    // no slot can be mistaken for having landed
+    std::memset(m_mapped, 0, (size_t)bufferInfo.size);
+}
+
+DepthReadback::~DepthReadback() {
+    const auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
+    const VkDevice device = VRManager::instance().VK->GetDevice();
+    dispatch->UnmapMemory(device, m_memory);
+    dispatch->DestroyBuffer(device, m_buffer, nullptr);
+    dispatch->FreeMemory(device, m_memory, nullptr);
+}
+
+void DepthReadback::Record(CopyBatch& batch, VkImage srcImage) {
+    std::lock_guard lock(m_mutex);
+    const uint32_t slotIdx = m_nextSlot;
+    Slot& slot = m_slots[slotIdx];
+    if (slot.reading || (slot.pending && slot.pendingPolls < MAX_PENDING_POLLS))
+        return;
+    if (++m_skippedRecords < READBACK_INTERVAL)
+        return;
+    m_skippedRecords = 0;
+
+    std::vector<VkBufferImageCopy> regions = { {
+        .bufferOffset = GetSlotOffset(slotIdx),
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1 },
+        .imageOffset = { 0, 0, 0 },
+        .imageExtent = { m_width, m_height, 1 }
+    } };
+
+    slot.marker = m_nextMarker++;
+    slot.pending = true;
+    slot.pendingPolls = 0;
+    batch.AddReadback({
+        .srcImage = srcImage,
+        .dstBuffer = m_buffer,
+        .regions = std::move(regions),
+        .markerOffset = GetSlotOffset(slotIdx) + GetDataSize(),
+        .marker = slot.marker
+    });
+    m_nextSlot = (m_nextSlot + 1) % SLOT_COUNT;
+}
+
+std::optional<DepthAnalysis::Range> DepthReadback::Poll() {
+    std::unique_lock lock(m_mutex);
+    if (!m_coherent) {
+        const VkMappedMemoryRange range = { VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, m_memory, 0, VK_WHOLE_SIZE };
+        checkVkResult(VRManager::instance().VK->GetDeviceDispatch()->InvalidateMappedMemoryRanges(VRManager::instance().VK->GetDevice(), 1, &range), "Failed to invalidate depth readback memory!");
+    }
+    std::optional<uint32_t> newestSlot;
+    for (uint32_t i = 0; i < SLOT_COUNT; ++i) {
+        Slot& slot = m_slots[i];
+        if (!slot.pending)
+            continue;
+
+        const uint32_t landedMarker = std::atomic_ref(*reinterpret_cast<uint32_t*>(m_mapped + GetSlotOffset(i) + GetDataSize())).load(std::memory_order_acquire);
+        if (landedMarker != slot.marker) {
+            slot.pendingPolls++;
+            continue;
+        }
+        slot.pending = false;
+        if (!newestSlot || slot.marker > m_slots[*newestSlot].marker)
+            newestSlot = i;
+    }
+    if (!newestSlot)
+        return std::nullopt;
+
+    // no readback is recorded into the slot while it's being read, so the lock isn't held during the reduction
+    Slot& slot = m_slots[*newestSlot];
+    slot.reading = true;
+    lock.unlock();
+    const DepthAnalysis::Range range = DepthAnalysis::Reduce(reinterpret_cast<const float*>(m_mapped + GetSlotOffset(*newestSlot)), (size_t)m_width * m_height);
+    lock.lock();
+    slot.reading = false;
+    return range;
+}
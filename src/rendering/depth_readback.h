@@ -0,0 +1,53 @@
+#pragma once
+
+#include "utils/barrier_batch.h"
+#include "utils/depth_analysis.h"
+
+#include <mutex>
+
+// Reads Cemu's whole depth buffer back into host memory, so that the range of depths in the scene can be measured on the CPU.
+// Each readback goes into its own slot and is followed by a marker, the CPU only uses a slot once its marker has landed.
+class DepthReadback {
+public:
+    // only every this many depth copies are read back, to bound the bandwidth and the CPU time spent on the analysis
+    static constexpr uint32_t READBACK_INTERVAL = 4;
+
+    DepthReadback(uint32_t width, uint32_t height);
+    ~DepthReadback();
+
+    // Adds the readback to the batch that also copies srcImage, which has to be in TRANSFER_SRC_OPTIMAL.
+    // It's skipped while the slot it would write into is still waiting for an earlier readback to land.
+    void Record(CopyBatch& batch, VkImage srcImage);
+    // returns the range of depths of the newest readback that landed since the last call
+    // the slot is reduced in place without holding the lock, Record() skips it in the meantime
+    std::optional<DepthAnalysis::Range> Poll();
+
+private:
+    static constexpr uint32_t SLOT_COUNT = 2;
+    // a readback whose command buffer was never submitted is given up on after this many polls
+    static constexpr uint32_t MAX_PENDING_POLLS = 16;
+
+    struct Slot {
+        uint32_t marker = 0;
+        bool pending = false;
+        bool reading = false;
+        uint32_t pendingPolls = 0;
+    };
+
+    VkDeviceSize GetDataSize() const { return (VkDeviceSize)m_width * m_height * sizeof(float); }
+    VkDeviceSize GetSlotOffset(uint32_t slot) const { return slot * (GetDataSize() + sizeof(uint32_t)); }
+
+    VkBuffer m_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    uint8_t* m_mapped = nullptr;
+    // without HOST_COHERENT the mapped memory has to be invalidated before the CPU can see what the GPU wrote
+    bool m_coherent = true;
+    uint32_t m_width;
+    uint32_t m_height;
+
+    std::mutex m_mutex;
+    std::array<Slot, SLOT_COUNT> m_slots = {};
+    uint32_t m_nextSlot = 0;
+    uint32_t m_nextMarker = 1;
+    uint32_t m_skippedRecords = 0;
+};
@@ -0,0 +1,74 @@
+#include "event_pump.h"
+#include "instance.h"
+
+
+XrEventPump::XrEventPump(XrInstance instance): m_instance(instance) {
+    m_thread = std::jthread([this](std::stop_token stopToken) { PumpThread(stopToken); });
+}
+
+XrEventPump::~XrEventPump() {
+    m_thread.request_stop();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+XrEventPump::Event XrEventPump::Decode(const XrEventDataBuffer& eventData) {
+    Event event = {};
+    event.structureType = eventData.type;
+    switch (eventData.type) {
+        case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED: {
+            const auto* stateChanged = reinterpret_cast<const XrEventDataSessionStateChanged*>(&eventData);
+            event.type = Event::Type::SESSION_STATE_CHANGED;
+            event.sessionState = stateChanged->state;
+            event.time = stateChanged->time;
+            break;
+        }
+        case XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED:
+            event.type = Event::Type::INTERACTION_PROFILE_CHANGED;
+            break;
+        case XR_TYPE_EVENT_DATA_REFERENCE_SPACE_CHANGE_PENDING: {
+            const auto* spaceChange = reinterpret_cast<const XrEventDataReferenceSpaceChangePending*>(&eventData);
+            event.type = Event::Type::REFERENCE_SPACE_CHANGE_PENDING;
+            event.referenceSpaceType = spaceChange->referenceSpaceType;
+            event.time = spaceChange->changeTime;
+            break;
+        }
+        case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING: {
+            const auto* instanceLoss = reinterpret_cast<const XrEventDataInstanceLossPending*>(&eventData);
+            event.type = Event::Type::INSTANCE_LOSS_PENDING;
+            event.time = instanceLoss->lossTime;
+            break;
+        }
+        case XR_TYPE_EVENT_DATA_EVENTS_LOST: {
+            const auto* eventsLost = reinterpret_cast<const XrEventDataEventsLost*>(&eventData);
+            event.type = Event::Type::EVENTS_LOST;
+            event.lostEventCount = eventsLost->lostEventCount;
+            break;
+        }
+        default:
+            event.type = Event::Type::UNKNOWN;
+            break;
+    }
+    return event;
+}
+
+void XrEventPump::PumpThread(std::stop_token stopToken) {
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    while (!stopToken.stop_requested()) {
+        while (m_queue.HasSpace()) {
+            XrEventDataBuffer eventData = { XR_TYPE_EVENT_DATA_BUFFER };
+            const XrResult result = xrPollEvent(m_instance, &eventData);
+            if (result != XR_SUCCESS) {
+                if (XR_FAILED(result)) {
+                    // the instance is lost or destroyed, there's nothing left to poll
+                    Log::print<ERROR>("xrPollEvent failed with result {}, stopping the event pump", (int)result);
+                    return;
+                }
+                break;
+            }
+            m_queue.TryPush(Decode(eventData));
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+}
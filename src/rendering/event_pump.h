@@ -0,0 +1,58 @@
+#pragma once
+
+#include "utils/spsc_queue.h"
+
+#include <thread>
+
+// Polls the OpenXR events on its own low priority thread, so that xrPollEvent is never called on Cemu's present path.
+// Events are decoded into small messages and handed over through a lock-free queue, the thread that drains them handles them the same way as before.
+// The pump stops polling while the queue is full, which leaves the remaining events queued in the runtime instead of dropping them.
+class XrEventPump {
+public:
+    struct Event {
+        enum class Type : uint8_t {
+            SESSION_STATE_CHANGED,
+            INTERACTION_PROFILE_CHANGED,
+            REFERENCE_SPACE_CHANGE_PENDING,
+            INSTANCE_LOSS_PENDING,
+            EVENTS_LOST,
+            UNKNOWN
+        };
+
+        Type type = Type::UNKNOWN;
+        XrStructureType structureType = XR_TYPE_UNKNOWN;
+        XrSessionState sessionState = XR_SESSION_STATE_UNKNOWN; // for SESSION_STATE_CHANGED
+        XrReferenceSpaceType referenceSpaceType = XR_REFERENCE_SPACE_TYPE_STAGE; // for REFERENCE_SPACE_CHANGE_PENDING
+        XrTime time = 0;
+        uint32_t lostEventCount = 0; // for EVENTS_LOST
+    };
+
+    static constexpr size_t QUEUE_SIZE = 64;
+
+    explicit XrEventPump(XrInstance instance);
+    ~XrEventPump();
+
+    // hands at most maxEvents events to the handler, so that a burst of events can't stall the caller
+    template <typename Handler>
+    size_t Drain(size_t maxEvents, Handler&& handler) {
+        size_t drained = 0;
+        while (drained < maxEvents) {
+            std::optional<Event> event = m_queue.TryPop();
+            if (!event)
+                break;
+            handler(event.value());
+            drained++;
+        }
+        return drained;
+    }
+
+private:
+    static constexpr auto POLL_INTERVAL = std::chrono::milliseconds(2);
+
+    static Event Decode(const XrEventDataBuffer& eventData);
+    void PumpThread(std::stop_token stopToken);
+
+    XrInstance m_instance;
+    SpscQueue<Event, QUEUE_SIZE> m_queue;
+    std::jthread m_thread;
+};
@@ -6,7 +6,7 @@ static XrBool32 XR_DebugUtilsMessengerCallback(XrDebugUtilsMessageSeverityFlagsE
     return XR_FALSE;
 }
 
-OpenXR::OpenXR() {
+static std::vector<std::string> EnumerateInstanceExtensions() {
     uint32_t xrExtensionCount = 0;
     xrEnumerateInstanceExtensionProperties(NULL, 0, &xrExtensionCount, NULL);
     std::vector<XrExtensionProperties> instanceExtensions;
@@ -19,58 +19,110 @@ OpenXR::OpenXR() {
         checkXRResult(result, "Couldn't enumerate OpenXR extensions!");
     }
 
-    // Create instance with required extensions
-    bool d3d12Supported = false;
-    bool depthSupported = false;
+    std::vector<std::string> extensionNames;
+    extensionNames.reserve(instanceExtensions.size());
+    for (const XrExtensionProperties& extensionProperties : instanceExtensions) {
+        extensionNames.emplace_back(extensionProperties.extensionName);
+    }
+    return extensionNames;
+}
+
+// identifies the active runtime the same way that the OpenXR loader picks it, so without loading the runtime itself
+static std::optional<ProbeCache::Key> GetRuntimeProbeKey() {
+    std::string manifestPath;
+    if (const char* runtimeOverride = std::getenv("XR_RUNTIME_JSON")) {
+        manifestPath = runtimeOverride;
+    }
+    else {
+        char activeRuntime[MAX_PATH] = {};
+        DWORD activeRuntimeSize = sizeof(activeRuntime);
+        if (RegGetValueA(HKEY_LOCAL_MACHINE, "SOFTWARE\\Khronos\\OpenXR\\1", "ActiveRuntime", RRF_RT_REG_SZ, NULL, activeRuntime, &activeRuntimeSize) != ERROR_SUCCESS)
+            return std::nullopt;
+        manifestPath = activeRuntime;
+    }
+
+    std::error_code error;
+    const auto writeTime = std::filesystem::last_write_time(manifestPath, error);
+    if (error)
+        return std::nullopt;
+    return ProbeCache::Key{ manifestPath, (uint64_t)writeTime.time_since_epoch().count() };
+}
+
+OpenXR::OpenXR() {
+    // the extensions that the runtime reported at the last launch are reused, which saves loading and querying the runtime twice
+    const auto probeStartTime = std::chrono::steady_clock::now();
+    const std::optional<ProbeCache::Key> probeKey = GetRuntimeProbeKey();
+    std::optional<ProbeCache::Entry> cachedProbe = probeKey ? ProbeCache::Load(PROBE_CACHE_PATH, *probeKey) : std::nullopt;
+    std::vector<std::string> availableExtensions = cachedProbe ? cachedProbe->instanceExtensions : EnumerateInstanceExtensions();
+    const double probeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - probeStartTime).count();
+    Log::print<INFO>("Probed OpenXR runtime extensions in {:.2f} ms ({})", probeMs, cachedProbe ? "cached" : "enumerated");
+
     bool timeConvSupported = false;
     bool debugUtilsSupported = false;
-    for (XrExtensionProperties& extensionProperties : instanceExtensions) {
-        Log::print<VERBOSE>("Found available OpenXR extension: {}", extensionProperties.extensionName);
-        if (strcmp(extensionProperties.extensionName, XR_KHR_D3D12_ENABLE_EXTENSION_NAME) == 0) {
-            d3d12Supported = true;
-        }
-        if (strcmp(extensionProperties.extensionName, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME) == 0) {
-            depthSupported = true;
-        }
-        else if (strcmp(extensionProperties.extensionName, XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME) == 0) {
-            timeConvSupported = true;
-        }
-        else if (strcmp(extensionProperties.extensionName, XR_EXT_DEBUG_UTILS_EXTENSION_NAME) == 0) {
+    auto createInstance = [&](const std::vector<std::string>& extensionNames) -> XrResult {
+        // Create instance with required extensions
+        bool d3d12Supported = false;
+        bool depthSupported = false;
+        timeConvSupported = false;
+        debugUtilsSupported = false;
+        for (const std::string& extensionName : extensionNames) {
+            Log::print<VERBOSE>("Found available OpenXR extension: {}{}", extensionName, cachedProbe ? " (cached from the last launch)" : "");
+            if (extensionName == XR_KHR_D3D12_ENABLE_EXTENSION_NAME) {
+                d3d12Supported = true;
+            }
+            if (extensionName == XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME) {
+                depthSupported = true;
+            }
+            else if (extensionName == XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME) {
+                timeConvSupported = true;
+            }
+            else if (extensionName == XR_EXT_DEBUG_UTILS_EXTENSION_NAME) {
 #if defined(_DEBUG)
-            debugUtilsSupported = Log::isLogTypeEnabled<VERBOSE>();
+                debugUtilsSupported = Log::isLogTypeEnabled<VERBOSE>();
 #endif
+            }
         }
-    }
 
-    if (!d3d12Supported) {
-        Log::print<ERROR>("OpenXR runtime doesn't support D3D12 (XR_KHR_D3D12_ENABLE)!");
-        throw std::runtime_error("Current OpenXR runtime doesn't support Direct3D 12 (XR_KHR_D3D12_ENABLE). See the Github page's troubleshooting section for a solution!");
-    }
-    if (!depthSupported) {
-        Log::print<ERROR>("OpenXR runtime doesn't support depth composition layers (XR_KHR_COMPOSITION_LAYER_DEPTH)!");
-        throw std::runtime_error("Current OpenXR runtime doesn't support depth composition layers (XR_KHR_COMPOSITION_LAYER_DEPTH). See the Github page's troubleshooting section for a solution!");
-    }
-    if (!timeConvSupported) {
-        Log::print<WARNING>("OpenXR runtime doesn't support converting time from/to XrTime (XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME). Not required, as of this version.");
-    }
-    if (!debugUtilsSupported) {
+        if (!d3d12Supported) {
+            Log::print<ERROR>("OpenXR runtime doesn't support D3D12 (XR_KHR_D3D12_ENABLE)!");
+            throw std::runtime_error("Current OpenXR runtime doesn't support Direct3D 12 (XR_KHR_D3D12_ENABLE). See the Github page's troubleshooting section for a solution!");
+        }
+        if (!depthSupported) {
+            Log::print<ERROR>("OpenXR runtime doesn't support depth composition layers (XR_KHR_COMPOSITION_LAYER_DEPTH)!");
+            throw std::runtime_error("Current OpenXR runtime doesn't support depth composition layers (XR_KHR_COMPOSITION_LAYER_DEPTH). See the Github page's troubleshooting section for a solution!");
+        }
+        if (!timeConvSupported) {
+            Log::print<WARNING>("OpenXR runtime doesn't support converting time from/to XrTime (XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME). Not required, as of this version.");
+        }
+        if (!debugUtilsSupported) {
 #if defined(_DEBUG)
-        Log::print<INFO>("OpenXR runtime doesn't support debug utils (XR_EXT_DEBUG_UTILS)! Errors/debug information will no longer be able to be shown!");
+            Log::print<INFO>("OpenXR runtime doesn't support debug utils (XR_EXT_DEBUG_UTILS)! Errors/debug information will no longer be able to be shown!");
 #endif
-    }
+        }
 
-    std::vector<const char*> enabledExtensions = { XR_KHR_D3D12_ENABLE_EXTENSION_NAME, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME, XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME };
-    if (debugUtilsSupported) enabledExtensions.emplace_back(XR_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        std::vector<const char*> enabledExtensions = { XR_KHR_D3D12_ENABLE_EXTENSION_NAME, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME, XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME };
+        if (debugUtilsSupported) enabledExtensions.emplace_back(XR_EXT_DEBUG_UTILS_EXTENSION_NAME);
+
+        XrInstanceCreateInfo xrInstanceCreateInfo = { XR_TYPE_INSTANCE_CREATE_INFO };
+        xrInstanceCreateInfo.createFlags = 0;
+        xrInstanceCreateInfo.enabledExtensionCount = (uint32_t)enabledExtensions.size();
+        xrInstanceCreateInfo.enabledExtensionNames = enabledExtensions.data();
+        xrInstanceCreateInfo.enabledApiLayerCount = 0;
+        xrInstanceCreateInfo.enabledApiLayerNames = NULL;
+        xrInstanceCreateInfo.applicationInfo = { "BetterVR", 1, "Cemu", 1, XR_API_VERSION_1_0 };
+        return xrCreateInstance(&xrInstanceCreateInfo, &m_instance);
+    };
 
-    XrInstanceCreateInfo xrInstanceCreateInfo = { XR_TYPE_INSTANCE_CREATE_INFO };
-    xrInstanceCreateInfo.createFlags = 0;
-    xrInstanceCreateInfo.enabledExtensionCount = (uint32_t)enabledExtensions.size();
-    xrInstanceCreateInfo.enabledExtensionNames = enabledExtensions.data();
-    xrInstanceCreateInfo.enabledApiLayerCount = 0;
-    xrInstanceCreateInfo.enabledApiLayerNames = NULL;
-    xrInstanceCreateInfo.applicationInfo = { "BetterVR", 1, "Cemu", 1, XR_API_VERSION_1_0 };
     {
-        XrResult result = xrCreateInstance(&xrInstanceCreateInfo, &m_instance);
+        XrResult result = createInstance(availableExtensions);
+        if (result == XR_ERROR_EXTENSION_NOT_PRESENT && cachedProbe) {
+            // the runtime was updated in place without its manifest changing, so the cached extensions are outdated
+            Log::print<WARNING>("Cached OpenXR runtime extensions are outdated, enumerating them again");
+            ProbeCache::Invalidate(PROBE_CACHE_PATH);
+            cachedProbe.reset();
+            availableExtensions = EnumerateInstanceExtensions();
+            result = createInstance(availableExtensions);
+        }
         if (result == XR_ERROR_RUNTIME_FAILURE) {
             Log::print<ERROR>("Failed to create OpenXR instance! Is the OpenXR runtime installed and set to the correct runtime? Restarting might help, or going to SteamVR/Oculus Link's Settings and making sure OpenXR is enabled.");
         }
@@ -131,10 +183,29 @@ OpenXR::OpenXR() {
 
     m_capabilities.isOculusLinkRuntime = std::string(properties.runtimeName) == "Oculus";
     Log::print<INFO>(" - Using Meta Quest Link OpenXR runtime: {}", m_capabilities.isOculusLinkRuntime ? "Yes" : "No");
+    Log::print<INFO>(" - Eye rendering: Stereo since {}", FoveationSupport::Describe(FoveationSupport::Detect(availableExtensions)));
+
+    if (probeKey) {
+        ProbeCache::Entry probe = { *probeKey, properties.runtimeName, properties.runtimeVersion, {}, std::move(availableExtensions) };
+        static_assert(sizeof(probe.adapterLuid) == sizeof(LUID));
+        memcpy(probe.adapterLuid.data(), &m_capabilities.adapter, sizeof(LUID));
+
+        if (!cachedProbe) {
+            ProbeCache::Store(PROBE_CACHE_PATH, probe);
+        }
+        else if (cachedProbe->runtimeName != probe.runtimeName || cachedProbe->runtimeVersion != probe.runtimeVersion || cachedProbe->adapterLuid != probe.adapterLuid) {
+            // the runtime is loaded by now, so enumerating its extensions again is cheap
+            Log::print<INFO>("OpenXR runtime or GPU changed since the last launch, refreshing the cached runtime extensions");
+            probe.instanceExtensions = EnumerateInstanceExtensions();
+            ProbeCache::Store(PROBE_CACHE_PATH, probe);
+        }
+    }
 
 }
 
 OpenXR::~OpenXR() {
+    // stop polling before anything the events refer to is destroyed
+    this->m_eventPump.reset();
     this->m_renderer.reset();
 
     if (m_headSpace != XR_NULL_HANDLE) {
@@ -193,6 +264,8 @@ void OpenXR::CreateSession(const XrGraphicsBindingD3D12KHR& d3d12Binding) {
     headSpaceCreateInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
     headSpaceCreateInfo.poseInReferenceSpace = s_xrIdentityPose;
     checkXRResult(xrCreateReferenceSpace(m_session, &headSpaceCreateInfo, &m_headSpace), "Failed to create reference space for head!");
+
+    m_eventPump = std::make_unique<XrEventPump>(m_instance);
 }
 
 void OpenXR::CreateActions() {
@@ -401,6 +474,48 @@ void OpenXR::CreateActions() {
         createInfo.poseInActionSpace = s_xrIdentityPose;
         checkXRResult(xrCreateActionSpace(m_session, &createInfo, &m_handSpaces[side]), "Failed to create action space for hand pose!");
     }
+    m_spaceRelations.SetSpaces(m_stageSpace, { m_headSpace, m_handSpaces[EyeSide::LEFT], m_handSpaces[EyeSide::RIGHT] });
+
+    // build the tables of the action states that UpdateActions() reads every frame
+    auto addQuery = [](std::vector<ActionQuery>& queries, XrAction action, XrPath subactionPath, XrActionType type, void* state, const char* errorMessage, ButtonState* buttonState = nullptr) {
+        XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
+        getInfo.action = action;
+        getInfo.subactionPath = subactionPath;
+        queries.emplace_back(ActionQuery{ getInfo, type, state, buttonState, 0.75f, errorMessage });
+    };
+
+    auto& inMenu = m_queriedInput.inMenu;
+    m_menuActionQueries.clear();
+    addQuery(m_menuActionQueries, m_scrollAction, XR_NULL_PATH, XR_ACTION_TYPE_VECTOR2F_INPUT, &inMenu.scroll, "Failed to get scroll action value!");
+    addQuery(m_menuActionQueries, m_navigateAction, XR_NULL_PATH, XR_ACTION_TYPE_VECTOR2F_INPUT, &inMenu.navigate, "Failed to get navigate action value!");
+    addQuery(m_menuActionQueries, m_selectAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.select, "Failed to get select action value!");
+    addQuery(m_menuActionQueries, m_backAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.back, "Failed to get back action value!");
+    addQuery(m_menuActionQueries, m_sortAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.sort, "Failed to get sort action value!");
+    addQuery(m_menuActionQueries, m_holdAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.hold, "Failed to get hold action value!");
+    addQuery(m_menuActionQueries, m_leftGripAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.leftGrip, "Failed to get left grip action value!");
+    addQuery(m_menuActionQueries, m_rightGripAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.rightGrip, "Failed to get right grip action value!");
+    addQuery(m_menuActionQueries, m_inMenu_mapAndInventoryAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.mapAndInventory, "Failed to get mapAndInventory action value!");
+    addQuery(m_menuActionQueries, m_inMenu_leftTriggerAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.leftTrigger, "Failed to get left trigger action value!");
+    addQuery(m_menuActionQueries, m_inMenu_rightTriggerAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inMenu.rightTrigger, "Failed to get right trigger action value!");
+
+    auto& inGame = m_queriedInput.inGame;
+    m_gameplayActionQueries.clear();
+    for (EyeSide side : { EyeSide::LEFT, EyeSide::RIGHT }) {
+        addQuery(m_gameplayActionQueries, m_grabAction, m_handPaths[side], XR_ACTION_TYPE_FLOAT_INPUT, &inGame.grab[side], "Failed to get grab action value!", &inGame.grabState[side]);
+    }
+    addQuery(m_gameplayActionQueries, m_inGame_mapAndInventoryAction, m_handPaths[EyeSide::RIGHT], XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.mapAndInventory, "Failed to get mapAndInventory action value!", &inGame.mapAndInventoryState);
+    addQuery(m_gameplayActionQueries, m_moveAction, XR_NULL_PATH, XR_ACTION_TYPE_VECTOR2F_INPUT, &inGame.move, "Failed to get move action value!");
+    addQuery(m_gameplayActionQueries, m_cameraAction, XR_NULL_PATH, XR_ACTION_TYPE_VECTOR2F_INPUT, &inGame.camera, "Failed to get camera action value!");
+    addQuery(m_gameplayActionQueries, m_interactAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.interact, "Failed to get interact action value!");
+    addQuery(m_gameplayActionQueries, m_cancelAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.cancel, "Failed to get cancel action value!");
+    addQuery(m_gameplayActionQueries, m_jumpAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.jump, "Failed to get jump action value!");
+    addQuery(m_gameplayActionQueries, m_crouchAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.crouch, "Failed to get crouch action value!");
+    addQuery(m_gameplayActionQueries, m_runAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.run, "Failed to get run action value!", &inGame.runState);
+    addQuery(m_gameplayActionQueries, m_attackAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.attack, "Failed to get attack action value!");
+    addQuery(m_gameplayActionQueries, m_useRuneAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.useRune, "Failed to get useRune action value!");
+    addQuery(m_gameplayActionQueries, m_throwWeaponAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.throwWeapon, "Failed to get throwWeapon action value!");
+    addQuery(m_gameplayActionQueries, m_inGame_leftTriggerAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.leftTrigger, "Failed to get left trigger action value!");
+    addQuery(m_gameplayActionQueries, m_inGame_rightTriggerAction, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT, &inGame.rightTrigger, "Failed to get right trigger action value!");
 
     // initialize rumble manager
     m_rumbleManager = std::make_unique<RumbleManager>(m_session, m_rumbleAction);
@@ -463,6 +578,45 @@ void CheckButtonState(bool buttonPressed, ButtonState& buttonState) {
     buttonState.wasDownLastFrame = down;
 }
 
+void OpenXR::QueryActions(const std::vector<ActionQuery>& queries) {
+    for (const ActionQuery& query : queries) {
+        bool isActive = false;
+        bool isPressed = false;
+        switch (query.type) {
+            case XR_ACTION_TYPE_BOOLEAN_INPUT: {
+                auto& state = *static_cast<XrActionStateBoolean*>(query.state);
+                state = { XR_TYPE_ACTION_STATE_BOOLEAN };
+                checkXRResult(xrGetActionStateBoolean(m_session, &query.getInfo, &state), query.errorMessage);
+                isActive = state.isActive == XR_TRUE;
+                isPressed = state.currentState == XR_TRUE;
+                break;
+            }
+            case XR_ACTION_TYPE_FLOAT_INPUT: {
+                auto& state = *static_cast<XrActionStateFloat*>(query.state);
+                state = { XR_TYPE_ACTION_STATE_FLOAT };
+                checkXRResult(xrGetActionStateFloat(m_session, &query.getInfo, &state), query.errorMessage);
+                isActive = state.isActive == XR_TRUE;
+                isPressed = state.currentState > query.pressThreshold;
+                break;
+            }
+            case XR_ACTION_TYPE_VECTOR2F_INPUT: {
+                auto& state = *static_cast<XrActionStateVector2f*>(query.state);
+                state = { XR_TYPE_ACTION_STATE_VECTOR2F };
+                checkXRResult(xrGetActionStateVector2f(m_session, &query.getInfo, &state), query.errorMessage);
+                isActive = state.isActive == XR_TRUE;
+                break;
+            }
+            default:
+                checkAssert(false, "Unsupported action type in action query table!");
+        }
+
+        // the button state is timing based (long presses, double press window), so it's updated on every frame and not just when the value changed
+        if (query.buttonState != nullptr && isActive) {
+            CheckButtonState(isPressed, *query.buttonState);
+        }
+    }
+}
+
 std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTime, glm::fquat controllerRotation, bool inMenu) {
     XrActiveActionSet activeActionSet = { (inMenu ? m_menuActionSet : m_gameplayActionSet), XR_NULL_PATH };
 
@@ -473,7 +627,9 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
 
     const float playerHeightOffsetMeters = CemuHooks::GetSettings().playerHeightSetting.getLE();
 
-    InputState newState = m_input.load();
+    // the action tables write straight into m_queriedInput
+    m_queriedInput = m_input.load();
+    InputState& newState = m_queriedInput;
     newState.inGame.in_game = !inMenu;
     newState.inGame.inputTime = predictedFrameTime;
     //newState.inGame.lastPickupSide = m_input.load().inGame.lastPickupSide;
@@ -481,73 +637,23 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
     //newState.inGame.mapAndInventoryState = m_input.load().inGame.mapAndInventoryState;
 
     if (inMenu) {
-        XrActionStateGetInfo getScrollInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getScrollInfo.action = m_scrollAction;
-        newState.inMenu.scroll = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getScrollInfo, &newState.inMenu.scroll), "Failed to get navigate action value!");
-
-        XrActionStateGetInfo getNavigationInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getNavigationInfo.action = m_navigateAction;
-        newState.inMenu.navigate = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getNavigationInfo, &newState.inMenu.navigate), "Failed to get select action value!");
-
-        XrActionStateGetInfo getSelectInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getSelectInfo.action = m_selectAction;
-        newState.inMenu.select = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getSelectInfo, &newState.inMenu.select), "Failed to get select action value!");
-
-        XrActionStateGetInfo getBackInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getBackInfo.action = m_backAction;
-        newState.inMenu.back = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getBackInfo, &newState.inMenu.back), "Failed to get back action value!");
-
-        XrActionStateGetInfo getSortInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getSortInfo.action = m_sortAction;
-        newState.inMenu.sort = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getSortInfo, &newState.inMenu.sort), "Failed to get sort action value!");
-
-        XrActionStateGetInfo getHoldInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getHoldInfo.action = m_holdAction;
-        newState.inMenu.hold = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getHoldInfo, &newState.inMenu.hold), "Failed to get hold action value!");
-
-        XrActionStateGetInfo getLeftGripInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getLeftGripInfo.action = m_leftGripAction;
-        newState.inMenu.leftGrip = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getLeftGripInfo, &newState.inMenu.leftGrip), "Failed to get left grip action value!");
+        QueryActions(m_menuActionQueries);
 
         if (newState.inMenu.leftGrip.currentState == XR_TRUE) {
             newState.inMenu.lastPickupSide = OpenXR::EyeSide::LEFT;
         }
-
-        XrActionStateGetInfo getRightGripInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRightGripInfo.action = m_rightGripAction;
-        newState.inMenu.rightGrip = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRightGripInfo, &newState.inMenu.rightGrip), "Failed to get right grip action value!");
-
         if (newState.inMenu.rightGrip.currentState == XR_TRUE) {
             newState.inMenu.lastPickupSide = OpenXR::EyeSide::RIGHT;
         }
-
-        XrActionStateGetInfo getMapAndInventoryInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getMapAndInventoryInfo.action = m_inMenu_mapAndInventoryAction;
-        newState.inMenu.mapAndInventory = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getMapAndInventoryInfo, &newState.inMenu.mapAndInventory), "Failed to get back action value!");
-
-        XrActionStateGetInfo getLeftTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getLeftTriggerInfo.action = m_inMenu_leftTriggerAction;
-        getLeftTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inMenu.leftTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getLeftTriggerInfo, &newState.inMenu.leftTrigger), "Failed to get left trigger action value!");
-
-        XrActionStateGetInfo getRightTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRightTriggerInfo.action = m_inMenu_rightTriggerAction;
-        getRightTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inMenu.rightTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRightTriggerInfo, &newState.inMenu.rightTrigger), "Failed to get right trigger action value!");
     }
     else {
+        // the filter is stepped by the time between the predicted display times
+        const float poseDeltaSeconds = m_lastPoseFilterTime == 0 ? 0.0f : (float)(predictedFrameTime - m_lastPoseFilterTime) / 1e9f;
+        m_lastPoseFilterTime = predictedFrameTime;
+
         for (EyeSide side : { EyeSide::LEFT, EyeSide::RIGHT }) {
+            ControllerPoseFilter::Sample poseSample = {};
+
             XrActionStateGetInfo getPoseInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
             getPoseInfo.action = m_gripPoseAction;
             getPoseInfo.subactionPath = m_handPaths[side];
@@ -555,19 +661,21 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
             checkXRResult(xrGetActionStatePose(m_session, &getPoseInfo, &newState.inGame.pose[side]), "Failed to get pose of controller!");
 
             if (newState.inGame.pose[side].isActive) {
+                const SpaceRelationCache::Space handSpace = side == EyeSide::LEFT ? SpaceRelationCache::LEFT_HAND : SpaceRelationCache::RIGHT_HAND;
                 {
-                    XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
-                    XrSpaceVelocity spaceVelocity = { XR_TYPE_SPACE_VELOCITY };
-                    spaceLocation.next = &spaceVelocity;
+                    auto [spaceLocation, spaceVelocity] = m_spaceRelations.Locate(handSpace, predictedFrameTime);
                     newState.inGame.poseVelocity[side].linearVelocity = { 0.0f, 0.0f, 0.0f };
                     newState.inGame.poseVelocity[side].angularVelocity = { 0.0f, 0.0f, 0.0f };
-                    checkXRResult(xrLocateSpace(m_handSpaces[side], m_stageSpace, predictedFrameTime, &spaceLocation), "Failed to get location from controllers!");
                     if ((spaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0 && (spaceLocation.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) != 0) {
                         // raise/lower the tracked pose in stage space
                         spaceLocation.pose.position.y += playerHeightOffsetMeters;
                         newState.inGame.poseLocation[side] = spaceLocation;
+                        poseSample.position = ToGLM(spaceLocation.pose.position);
+                        poseSample.orientation = ToGLM(spaceLocation.pose.orientation);
+                        poseSample.positionValid = true;
+                        poseSample.orientationValid = true;
 
-                        if ((spaceLocation.locationFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) != 0 && (spaceLocation.locationFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) != 0) {
+                        if ((spaceVelocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) != 0 && (spaceVelocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) != 0) {
                             // rotate angular velocity to world space when it's using a buggy runtime
                             auto mode = CemuHooks::GetSettings().AngularVelocityFixer_GetMode();
                             bool isUsingQuestRuntime = m_capabilities.isOculusLinkRuntime;
@@ -579,12 +687,15 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
                             }
 
                             newState.inGame.poseVelocity[side] = spaceVelocity;
+                            poseSample.linearVelocity = ToGLM(spaceVelocity.linearVelocity);
+                            poseSample.angularVelocity = ToGLM(spaceVelocity.angularVelocity);
+                            poseSample.velocityValid = true;
                         }
                     }
                 }
                 {
-                    XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
-                    checkXRResult(xrLocateSpace(m_handSpaces[side], m_headSpace, predictedFrameTime, &spaceLocation), "Failed to get location from controllers!");
+                    // derived from the stage locations, so that the head and hands are only located once per frame
+                    XrSpaceLocation spaceLocation = m_spaceRelations.Relate(SpaceRelationCache::HEAD, handSpace, predictedFrameTime);
                     if ((spaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0 && (spaceLocation.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) != 0) {
                         spaceLocation.pose.position.y += playerHeightOffsetMeters;
                         newState.inGame.hmdRelativePoseLocation[side] = spaceLocation;
@@ -592,114 +703,17 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
                 }
             }
 
-            XrActionStateGetInfo getGrabInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-            getGrabInfo.action = m_grabAction;
-            getGrabInfo.subactionPath = m_handPaths[side];
-            newState.inGame.grab[side] = { XR_TYPE_ACTION_STATE_FLOAT };
-            checkXRResult(xrGetActionStateFloat(m_session, &getGrabInfo, &newState.inGame.grab[side]), "Failed to get grab action value!");
-
-            auto& action = newState.inGame.grab[side];
-            auto& buttonState = newState.inGame.grabState[side];
-            if (action.isActive == XR_TRUE) {
-                auto buttonPressed = action.currentState > 0.75f;
-                CheckButtonState(buttonPressed, buttonState);
+            // the hands are already located at the predicted display time, extrapolating them further would only overshoot
+            const ControllerPoseFilter::Result filtered = m_poseFilters[side].Update(poseSample, poseDeltaSeconds, 0.0f);
+            XrSpaceLocation& filteredLocation = newState.inGame.filteredPoseLocation[side];
+            filteredLocation = { XR_TYPE_SPACE_LOCATION };
+            filteredLocation.pose = { ToXR(filtered.orientation), ToXR(filtered.position) };
+            if (filtered.valid) {
+                filteredLocation.locationFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
             }
         }
 
-        XrActionStateGetInfo getMapAndInventoryInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getMapAndInventoryInfo.action = m_inGame_mapAndInventoryAction;
-        getMapAndInventoryInfo.subactionPath = m_handPaths[1];
-        newState.inGame.mapAndInventory = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getMapAndInventoryInfo, &newState.inGame.mapAndInventory), "Failed to get mapAndInventory action value!");
-
-        auto& mapAndInventoryAction = newState.inGame.mapAndInventory;
-        auto& mapAndInventoryButtonState = newState.inGame.mapAndInventoryState;
-        if (mapAndInventoryAction.isActive == XR_TRUE) {
-            auto buttonPressed = mapAndInventoryAction.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, mapAndInventoryButtonState);
-        }
-
-        //XrActionStateGetInfo getInventory = { XR_TYPE_ACTION_STATE_GET_INFO };
-        //getInventory.action = m_inGame_inventoryAction;
-        //newState.inGame.inventory = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        //checkXRResult(xrGetActionStateBoolean(m_session, &getInventory, &newState.inGame.inventory), "Failed to get inventory action value!");
-
-        XrActionStateGetInfo getMoveInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getMoveInfo.action = m_moveAction;
-        newState.inGame.move = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getMoveInfo, &newState.inGame.move), "Failed to get move action value!");
-
-        XrActionStateGetInfo getCameraInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getCameraInfo.action = m_cameraAction;
-        newState.inGame.camera = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getCameraInfo, &newState.inGame.camera), "Failed to get camera action value!");
-
-        XrActionStateGetInfo getInteractInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getInteractInfo.action = m_interactAction;
-        getInteractInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.interact = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getInteractInfo, &newState.inGame.interact), "Failed to get interact action value!");
-
-        XrActionStateGetInfo getCancelInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getCancelInfo.action = m_cancelAction;
-        getCancelInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.cancel = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getCancelInfo, &newState.inGame.cancel), "Failed to get cancel action value!");
-
-        XrActionStateGetInfo getJumpInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getJumpInfo.action = m_jumpAction;
-        getJumpInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.jump = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getJumpInfo, &newState.inGame.jump), "Failed to get jump action value!");
-
-        XrActionStateGetInfo getCrouchInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getCrouchInfo.action = m_crouchAction;
-        getCrouchInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.crouch = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getCrouchInfo, &newState.inGame.crouch), "Failed to get crouch action value!");
-
-        XrActionStateGetInfo getRunInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRunInfo.action = m_runAction;
-        getRunInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.run = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRunInfo, &newState.inGame.run), "Failed to get run action value!");
-
-        auto& runAction = newState.inGame.run;
-        auto& runButtonState = newState.inGame.runState;
-        if (runAction.isActive == XR_TRUE) {
-            auto buttonPressed = runAction.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, runButtonState);
-        }
-
-        XrActionStateGetInfo getAttackInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getAttackInfo.action = m_attackAction;
-        getAttackInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.attack = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getAttackInfo, &newState.inGame.attack), "Failed to get attack action value!");
-
-        XrActionStateGetInfo getUseRuneInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getUseRuneInfo.action = m_useRuneAction;
-        getUseRuneInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.useRune = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getUseRuneInfo, &newState.inGame.useRune), "Failed to get useRune action value!");
-
-        XrActionStateGetInfo getThrowWeaponInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getThrowWeaponInfo.action = m_throwWeaponAction;
-        getThrowWeaponInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.throwWeapon = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getThrowWeaponInfo, &newState.inGame.throwWeapon), "Failed to get throwWeapon action value!");
-
-        XrActionStateGetInfo getLeftTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getLeftTriggerInfo.action = m_inGame_leftTriggerAction;
-        getLeftTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.leftTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getLeftTriggerInfo, &newState.inGame.leftTrigger), "Failed to get left trigger action value!");
-
-        XrActionStateGetInfo getRightTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRightTriggerInfo.action = m_inGame_rightTriggerAction;
-        getRightTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.rightTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRightTriggerInfo, &newState.inGame.rightTrigger), "Failed to get right trigger action value!");
+        QueryActions(m_gameplayActionQueries);
     }
     this->m_input.store(newState);
     return newState;
@@ -707,13 +721,7 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
 
 
 std::optional<XrSpaceLocation> OpenXR::UpdateSpaces(XrTime predictedDisplayTime) {
-    XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
-    if (XrResult result = xrLocateSpace(m_headSpace, m_stageSpace, predictedDisplayTime, &spaceLocation); XR_SUCCEEDED(result)) {
-        if (result != XR_ERROR_TIME_INVALID) {
-            checkXRResult(result, "Failed to get space location!");
-        }
-        checkXRResult(result, "Failed to get space location!");
-    }
+    XrSpaceLocation spaceLocation = m_spaceRelations.Locate(SpaceRelationCache::HEAD, predictedDisplayTime).location;
     if ((spaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 0)
         return std::nullopt;
 
@@ -721,8 +729,11 @@ std::optional<XrSpaceLocation> OpenXR::UpdateSpaces(XrTime predictedDisplayTime)
 }
 
 void OpenXR::ProcessEvents() {
-    auto processSessionStateChangedEvent = [this](XrEventDataSessionStateChanged* stateChangedEvent) {
-        switch (stateChangedEvent->state) {
+    if (!m_eventPump)
+        return;
+
+    auto processSessionStateChangedEvent = [this](XrSessionState state) {
+        switch (state) {
             case XR_SESSION_STATE_IDLE:
                 Log::print<VERBOSE>("OpenXR has indicated that the session is idle!");
                 break;
@@ -764,29 +775,27 @@ void OpenXR::ProcessEvents() {
         }
     };
 
-    XrEventDataBuffer eventData = { XR_TYPE_EVENT_DATA_BUFFER };
-    XrResult result = xrPollEvent(m_instance, &eventData);
-
-    while (result == XR_SUCCESS) {
-        switch (eventData.type) {
-            case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED:
-                processSessionStateChangedEvent((XrEventDataSessionStateChanged*)&eventData);
+    // the events were already polled on the event pump's thread, this only handles them
+    m_eventPump->Drain(MAX_EVENTS_PER_DRAIN, [&](const XrEventPump::Event& event) {
+        switch (event.type) {
+            case XrEventPump::Event::Type::SESSION_STATE_CHANGED:
+                processSessionStateChangedEvent(event.sessionState);
                 break;
-            case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING:
+            case XrEventPump::Event::Type::INSTANCE_LOSS_PENDING:
                 Log::print<WARNING>("OpenXR has indicated that the instance is going to be lost!");
                 break;
-            case XR_TYPE_EVENT_DATA_EVENTS_LOST:
-                Log::print<WARNING>("OpenXR has indicated that events are being lost!");
+            case XrEventPump::Event::Type::EVENTS_LOST:
+                Log::print<WARNING>("OpenXR has indicated that {} events were lost!", event.lostEventCount);
                 break;
-            case XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED:
+            case XrEventPump::Event::Type::INTERACTION_PROFILE_CHANGED:
                 Log::print<WARNING>("OpenXR has indicated that the interaction profile has changed!");
                 break;
+            case XrEventPump::Event::Type::REFERENCE_SPACE_CHANGE_PENDING:
+                Log::print<VERBOSE>("OpenXR has indicated that reference space {} is going to change!", std::to_underlying(event.referenceSpaceType));
+                break;
             default:
-                Log::print<WARNING>("OpenXR has indicated that an unknown event with type {} has occurred!", std::to_underlying(eventData.type));
+                Log::print<WARNING>("OpenXR has indicated that an unknown event with type {} has occurred!", std::to_underlying(event.structureType));
                 break;
         }
-
-        eventData = { XR_TYPE_EVENT_DATA_BUFFER };
-        result = xrPollEvent(m_instance, &eventData);
-    }
+    });
 }
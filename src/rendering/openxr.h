@@ -1,6 +1,11 @@
 #pragma once
 
 #include "hooking/rumble.h"
+#include "rendering/event_pump.h"
+#include "utils/foveation_support.h"
+#include "utils/pose_filter.h"
+#include "utils/probe_cache.h"
+#include "utils/space_relations.h"
 
 class OpenXR {
     friend class RND_Renderer;
@@ -79,6 +84,8 @@ public:
             std::array<XrActionStatePose, 2> pose;
             std::array<XrSpaceLocation, 2> poseLocation;
             std::array<XrSpaceVelocity, 2> poseVelocity;
+            // smoothed version of poseLocation that every hand visual uses, flags are cleared while tracking is lost but the pose keeps the last filtered one
+            std::array<XrSpaceLocation, 2> filteredPoseLocation;
             // todo: remove relative controller positions if it turns out to be unnecessary
             std::array<XrSpaceLocation, 2> hmdRelativePoseLocation;
         } inGame;
@@ -134,6 +141,17 @@ public:
     RumbleManager* GetRumbleManager() const { return m_rumbleManager.get(); }
 
 private:
+    // An action state that's read every frame, along with the prebuilt get-info struct and the field of m_queriedInput it's read into.
+    struct ActionQuery {
+        XrActionStateGetInfo getInfo;
+        XrActionType type;
+        void* state; // XrActionStateBoolean, XrActionStateFloat or XrActionStateVector2f depending on type
+        InputState::InGame::ButtonState* buttonState; // optional, updated every frame that the action is active
+        float pressThreshold; // value above which a float action counts as pressed
+        const char* errorMessage;
+    };
+    void QueryActions(const std::vector<ActionQuery>& queries);
+
     XrPath GetXRPath(const char* str) const {
         XrPath path;
         checkXRResult(xrStringToPath(m_instance, str, &path), std::format("Failed to get path for {}", str).c_str());
@@ -147,6 +165,9 @@ private:
     XrSpace m_headSpace = XR_NULL_HANDLE;
     std::array<XrSpace, 2> m_handSpaces = { XR_NULL_HANDLE, XR_NULL_HANDLE };
     std::array<XrPath, 2> m_handPaths = { XR_NULL_PATH, XR_NULL_PATH };
+    SpaceRelationCache m_spaceRelations;
+    std::array<ControllerPoseFilter, 2> m_poseFilters;
+    XrTime m_lastPoseFilterTime = 0;
 
     // gameplay actions
     XrActionSet m_gameplayActionSet = XR_NULL_HANDLE;
@@ -188,8 +209,19 @@ private:
 
     XrAction m_inMenu_mapAndInventoryAction = XR_NULL_HANDLE;
 
+    // built once in CreateActions(), only the table of the active action set is queried
+    std::vector<ActionQuery> m_gameplayActionQueries;
+    std::vector<ActionQuery> m_menuActionQueries;
+    InputState m_queriedInput = {};
+
     std::unique_ptr<RND_Renderer> m_renderer;
     std::unique_ptr<RumbleManager> m_rumbleManager;
+    std::unique_ptr<XrEventPump> m_eventPump;
+    // events beyond this are left in the queue for the next present
+    static constexpr size_t MAX_EVENTS_PER_DRAIN = 8;
+
+    // written next to BetterVR.txt, see ProbeCache
+    static constexpr const char* PROBE_CACHE_PATH = "BetterVR_probe.bin";
 
     constexpr static XrPosef s_xrIdentityPose = { .orientation = { .x = 0, .y = 0, .z = 0, .w = 1 }, .position = { .x = 0, .y = 0, .z = 0 } };
 
@@ -26,14 +26,32 @@ RND_Renderer::~RND_Renderer() {
 }
 
 void RND_Renderer::StartFrame() {
+    const auto startFrameStart = std::chrono::steady_clock::now();
     m_isInitialized = true;
+    m_perfStats.BeginFrame();
 
+    const auto waitFrameStart = std::chrono::steady_clock::now();
     XrFrameWaitInfo waitFrameInfo = { XR_TYPE_FRAME_WAIT_INFO };
     checkXRResult(xrWaitFrame(m_session, &waitFrameInfo, &m_frameState), "Failed to wait for next frame!");
+    const auto waitFrameEnd = std::chrono::steady_clock::now();
+
+    if (m_lastPredictedDisplayTime != 0 && m_frameState.predictedDisplayPeriod > 0) {
+        const XrDuration interval = m_frameState.predictedDisplayTime - m_lastPredictedDisplayTime;
+        m_perfStats.AddPacingError((float)((double)std::abs(interval - m_frameState.predictedDisplayPeriod) / 1'000'000.0));
+    }
+    m_lastPredictedDisplayTime = m_frameState.predictedDisplayTime;
 
     XrFrameBeginInfo beginFrameInfo = { XR_TYPE_FRAME_BEGIN_INFO };
     checkXRResult(xrBeginFrame(m_session, &beginFrameInfo), "Couldn't begin OpenXR frame!");
 
+    // the swapchain images were acquired when they were last released, so by now they're usually ready and won't block when rendering
+    if (m_layer3D) {
+        m_layer3D->PollSwapchains();
+    }
+    if (m_layer2D) {
+        m_layer2D->PollSwapchains();
+    }
+
     VRManager::instance().D3D12->StartFrame();
     this->UpdateViews(m_frameState.predictedDisplayTime);
 
@@ -46,81 +64,109 @@ void RND_Renderer::StartFrame() {
         // todo: update this as late as possible
         VRManager::instance().XR->UpdateActions(m_frameState.predictedDisplayTime, headsetRotation.value(), !VRManager::instance().Hooks->IsInGame());
     }
+
+    m_startFrameCpuMs = std::chrono::duration<float, std::milli>((waitFrameStart - startFrameStart) + (std::chrono::steady_clock::now() - waitFrameEnd)).count();
 }
 
 
 void RND_Renderer::EndFrame() {
     static uint32_t s_endFrameCount = 0;
     s_endFrameCount++;
+    const auto endFrameStart = std::chrono::steady_clock::now();
 
-    std::vector<XrCompositionLayerBaseHeader*> compositionLayers;
+    // all layers of the frame are built in place, so that submitting a frame doesn't allocate
+    m_layerArena.Reset();
 
     m_presented2DLastFrame = false;
 
-    XrCompositionLayerProjection layer3D = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
     std::array<XrCompositionLayerProjectionView, 2> layer3DViews = {};
-    std::vector<XrCompositionLayerQuad> layer2DQuads;
 
-    long frameIdx = -1;
-    if (m_renderFrames[0].Is3DComplete() && m_renderFrames[0].Is2DComplete()) {
-        frameIdx = 0;
-    }
-    else if (m_renderFrames[1].Is3DComplete() && m_renderFrames[1].Is2DComplete()) {
-        frameIdx = 1;
-    }
-    else if (m_renderFrames[0].Is2DComplete()) {
-        frameIdx = 0;
-    }
-    else if (m_renderFrames[1].Is2DComplete()) {
-        frameIdx = 1;
+    const std::optional<size_t> submittedSlot = m_frameRing.BeginSubmit();
+    const long frameIdx = submittedSlot.has_value() ? (long)submittedSlot.value() : -1;
+    if (!submittedSlot.has_value()) {
+        // the game stopped halfway through a frame, e.g. because it's loading
+        if (auto stalledSlot = m_frameRing.FindStalledSlot(FRAME_STALL_THRESHOLD)) {
+            const auto captureStart = m_frameRing.GetTransitionTime(stalledSlot.value(), FrameRingType::State::CAPTURING);
+            if (captureStart != m_lastReportedStall) {
+                m_lastReportedStall = captureStart;
+                Log::print<VERBOSE>("Frame {} has been capturing for over {}ms without being completed", stalledSlot.value(), std::chrono::duration_cast<std::chrono::milliseconds>(FRAME_STALL_THRESHOLD).count());
+            }
+        }
     }
 
+    bool rendered3D = false;
+    float swapchainWaitMs = 0.0f;
     if (frameIdx != -1) {
+        // locate the poses as late as possible to measure how far off the poses that were rendered with are
+        // only while the performance HUD shows the result, since it locates the views and hands once more
+        if (m_performanceHUDVisible) {
+            LateLatchPoses(frameIdx);
+        }
+
         if (m_layer3D) {
-            if (m_renderFrames[frameIdx].Is3DComplete()) {
+            m_perfStats.SetFenceLag(m_layer3D->GetFenceLag(frameIdx));
+            if (m_frameRing.HasCaptures(frameIdx, FrameRingType::CAPTURES_3D)) {
                 m_layer3D->StartRendering();
+                swapchainWaitMs += m_layer3D->GetSwapchainWaitMs();
                 m_layer3D->Render(OpenXR::EyeSide::LEFT, frameIdx);
                 m_layer3D->Render(OpenXR::EyeSide::RIGHT, frameIdx);
                 layer3DViews = m_layer3D->FinishRendering(frameIdx);
-                layer3D.layerFlags = 0;
-                layer3D.space = VRManager::instance().XR->m_stageSpace;
-                layer3D.viewCount = (uint32_t)layer3DViews.size();
-                layer3D.views = layer3DViews.data();
-                if (CemuHooks::IsInGame()) {
-                    m_renderFrames[frameIdx].presented3D = true;
-                    compositionLayers.emplace_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer3D));
-                }
-                else {
-                    m_renderFrames[frameIdx].presented3D = false;
-                }
-            } else {
-                m_renderFrames[frameIdx].presented3D = false;
+                rendered3D = true;
+            }
+        }
+    }
+
+    bool presented3D = false;
+    bool repeated3D = false;
+    if (m_layer3D) {
+        // If the game didn't finish a 3D frame in time, the last one is submitted again with the poses it was rendered with.
+        // The runtime then reprojects it to the current head pose using its depth, instead of the 3D layer disappearing for a frame.
+        const ReprojectionFallback::Decision decision = m_reprojectionFallback.Decide(rendered3D, CemuHooks::IsInGame());
+        if (decision == ReprojectionFallback::Decision::REPEAT_LAST) {
+            layer3DViews = m_layer3D->GetFinishedViews();
+            m_perfStats.AddRepeatedFrame();
+            repeated3D = true;
+            if (m_currViews.has_value()) {
+                const XrPosef& renderPose = layer3DViews[OpenXR::EyeSide::LEFT].pose;
+                const XrPosef& currentPose = m_currViews.value()[OpenXR::EyeSide::LEFT].pose;
+                m_perfStats.AddRepeatError(glm::degrees(PoseDelta::Compute(ToGLM(renderPose.position), ToGLM(renderPose.orientation), ToGLM(currentPose.position), ToGLM(currentPose.orientation)).angleError));
             }
         }
+        if (decision != ReprojectionFallback::Decision::SKIP) {
+            m_layerArena.AddProjection(0, VRManager::instance().XR->m_stageSpace, layer3DViews);
+        }
+        presented3D = decision == ReprojectionFallback::Decision::SUBMIT_NEW;
+    }
 
+    if (frameIdx != -1) {
         if (m_layer2D) {
             m_layer2D->StartRendering();
+            swapchainWaitMs += m_layer2D->GetSwapchainWaitMs();
             m_layer2D->Render(frameIdx);
-            layer2DQuads = m_layer2D->FinishRendering(m_frameState.predictedDisplayTime, frameIdx);
+            m_layer2D->FinishRendering(m_frameState.predictedDisplayTime, frameIdx, m_layerArena);
             m_presented2DLastFrame = true;
-            for (auto& layer : layer2DQuads) {
-                compositionLayers.emplace_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer));
-            }
         }
 
         m_renderFrames[frameIdx].Reset();
+        m_frameRing.FinishSubmit(frameIdx, presented3D);
+    }
+    else if (repeated3D && m_layer2D) {
+        // the HUD is drawn on top of the repeated 3D layer, so it would flicker if it was left out of the repeated frame
+        if (const auto& finishedQuad = m_layer2D->GetFinishedQuad()) {
+            m_layerArena.AddQuad(finishedQuad.value());
+        }
     }
 
     XrFrameEndInfo frameEndInfo = { XR_TYPE_FRAME_END_INFO };
     frameEndInfo.displayTime = m_frameState.predictedDisplayTime;
     frameEndInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
-    frameEndInfo.layerCount = (uint32_t)compositionLayers.size();
-    frameEndInfo.layers = compositionLayers.data();
+    frameEndInfo.layerCount = m_layerArena.GetLayerCount();
+    frameEndInfo.layers = m_layerArena.GetLayers();
 
     if (s_endFrameCount % 500 == 0) {
         Log::print<VERBOSE>("EndFrame #{}: frameIdx={}, layers={}, 3D={}, 2D={}",
-            s_endFrameCount, frameIdx, compositionLayers.size(),
-            (frameIdx != -1 && m_renderFrames[frameIdx].presented3D) ? "yes" : "no",
+            s_endFrameCount, frameIdx, m_layerArena.GetLayerCount(),
+            presented3D ? "yes" : "no",
             m_presented2DLastFrame ? "yes" : "no");
     }
 
@@ -129,10 +175,17 @@ void RND_Renderer::EndFrame() {
         Log::print<ERROR>("xrEndFrame #{} FAILED with result {}", s_endFrameCount, (int)xrResult);
     }
 
+    const auto fenceWaitStart = std::chrono::steady_clock::now();
+    m_lastSubmitCpuMs = std::chrono::duration<float, std::milli>(fenceWaitStart - endFrameStart).count();
+    m_perfStats.AddFrameLoopTime(m_startFrameCpuMs + m_lastSubmitCpuMs);
+    m_perfStats.AddSwapchainWait(swapchainWaitMs);
     VRManager::instance().D3D12->EndFrame();
+    m_perfStats.EndFrame(frameIdx == -1, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - fenceWaitStart).count());
+    HookProfiler::Aggregate();
+    m_texturePool.Update();
 }
 
-RND_Renderer::Layer3D::Layer3D(VkExtent2D extent) {
+RND_Renderer::Layer3D::Layer3D(SharedTexturePool& texturePool, VkExtent2D extent): m_texturePool(texturePool), m_extent(extent) {
     auto viewConfs = VRManager::instance().XR->GetViewConfigurations();
 
     this->m_presentPipelines[OpenXR::EyeSide::LEFT] = std::make_unique<RND_D3D12::PresentPipeline<true>>(VRManager::instance().XR->GetRenderer());
@@ -144,20 +197,10 @@ RND_Renderer::Layer3D::Layer3D(VkExtent2D extent) {
     this->m_depthSwapchains[OpenXR::EyeSide::LEFT] = std::make_unique<Swapchain<DXGI_FORMAT_D32_FLOAT>>(viewConfs[0].recommendedImageRectWidth, viewConfs[0].recommendedImageRectHeight, viewConfs[0].recommendedSwapchainSampleCount);
     this->m_depthSwapchains[OpenXR::EyeSide::RIGHT] = std::make_unique<Swapchain<DXGI_FORMAT_D32_FLOAT>>(viewConfs[1].recommendedImageRectWidth, viewConfs[1].recommendedImageRectHeight, viewConfs[1].recommendedSwapchainSampleCount);
 
-    this->m_presentPipelines[OpenXR::EyeSide::LEFT]->BindSettings((float)this->m_swapchains[OpenXR::EyeSide::LEFT]->GetWidth(), (float)this->m_swapchains[OpenXR::EyeSide::LEFT]->GetHeight());
-    this->m_presentPipelines[OpenXR::EyeSide::RIGHT]->BindSettings((float)this->m_swapchains[OpenXR::EyeSide::RIGHT]->GetWidth(), (float)this->m_swapchains[OpenXR::EyeSide::RIGHT]->GetHeight());
-
     // initialize textures
-    for (int i = 0; i < 2; ++i) {
-        this->m_textures[OpenXR::EyeSide::LEFT][i] = std::make_unique<SharedTexture>(extent.width, extent.height, VK_FORMAT_B10G11R11_UFLOAT_PACK32, D3D12Utils::ToDXGIFormat(VK_FORMAT_B10G11R11_UFLOAT_PACK32));
-        this->m_textures[OpenXR::EyeSide::RIGHT][i] = std::make_unique<SharedTexture>(extent.width, extent.height, VK_FORMAT_B10G11R11_UFLOAT_PACK32, D3D12Utils::ToDXGIFormat(VK_FORMAT_B10G11R11_UFLOAT_PACK32));
-        this->m_depthTextures[OpenXR::EyeSide::LEFT][i] = std::make_unique<SharedTexture>(extent.width, extent.height, VK_FORMAT_D32_SFLOAT, D3D12Utils::ToDXGIFormat(VK_FORMAT_D32_SFLOAT));
-        this->m_depthTextures[OpenXR::EyeSide::RIGHT][i] = std::make_unique<SharedTexture>(extent.width, extent.height, VK_FORMAT_D32_SFLOAT, D3D12Utils::ToDXGIFormat(VK_FORMAT_D32_SFLOAT));
-
-        this->m_textures[OpenXR::EyeSide::LEFT][i]->d3d12GetTexture()->SetName(L"Layer3D - Left Color Texture");
-        this->m_textures[OpenXR::EyeSide::RIGHT][i]->d3d12GetTexture()->SetName(L"Layer3D - Right Color Texture");
-        this->m_depthTextures[OpenXR::EyeSide::LEFT][i]->d3d12GetTexture()->SetName(L"Layer3D - Left Depth Texture");
-        this->m_depthTextures[OpenXR::EyeSide::RIGHT][i]->d3d12GetTexture()->SetName(L"Layer3D - Right Depth Texture");
+    AcquireTextures(extent);
+    for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        m_depthReadbacks[side] = std::make_shared<DepthReadback>(extent.width, extent.height);
     }
 
     ComPtr<ID3D12CommandAllocator> cmdAllocator;
@@ -186,9 +229,48 @@ RND_Renderer::Layer3D::~Layer3D() {
     for (auto& swapchain : m_swapchains) {
         swapchain.reset();
     }
+    ReleaseTextures();
+}
+
+void RND_Renderer::Layer3D::AcquireTextures(VkExtent2D extent) {
+    const auto colorKey = SharedTexturePool::MakeKey(extent, VK_FORMAT_B10G11R11_UFLOAT_PACK32);
+    const auto depthKey = SharedTexturePool::MakeKey(extent, VK_FORMAT_D32_SFLOAT);
+    for (int i = 0; i < 2; ++i) {
+        this->m_textures[OpenXR::EyeSide::LEFT][i] = m_texturePool.Acquire(colorKey, L"Layer3D - Left Color Texture");
+        this->m_textures[OpenXR::EyeSide::RIGHT][i] = m_texturePool.Acquire(colorKey, L"Layer3D - Right Color Texture");
+        this->m_depthTextures[OpenXR::EyeSide::LEFT][i] = m_texturePool.Acquire(depthKey, L"Layer3D - Left Depth Texture");
+        this->m_depthTextures[OpenXR::EyeSide::RIGHT][i] = m_texturePool.Acquire(depthKey, L"Layer3D - Right Depth Texture");
+    }
 }
 
-SharedTexture* RND_Renderer::Layer3D::CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx, VkImageLayout srcImageLayout) {
+void RND_Renderer::Layer3D::ReleaseTextures() {
+    for (int i = 0; i < 2; ++i) {
+        for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            m_texturePool.Release(std::move(this->m_textures[side][i]));
+            m_texturePool.Release(std::move(this->m_depthTextures[side][i]));
+        }
+    }
+}
+
+void RND_Renderer::Layer3D::Resize(VkExtent2D extent) {
+    Log::print<INFO>("Resizing 3D layer textures from {}x{} to {}x{}", m_extent.width, m_extent.height, extent.width, extent.height);
+    // the old textures can still be used by copies that haven't been submitted yet, the pool keeps them alive until they've retired
+    {
+        std::scoped_lock lock(m_texturesMutex);
+        ReleaseTextures();
+        AcquireTextures(extent);
+        m_extent = extent;
+
+        // the readback buffers can still be written to by a frame that's in flight
+        m_texturePool.DeferDestruction([oldReadbacks = m_depthReadbacks] {});
+        for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            m_depthReadbacks[side] = std::make_shared<DepthReadback>(extent.width, extent.height);
+            m_depthAnalysisAge[side] = MAX_DEPTH_ANALYSIS_AGE;
+        }
+    }
+}
+
+SharedTexture* RND_Renderer::Layer3D::CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer cmdBuffer, CopyBatch& copyBatch, VkImage image, long frameIdx, VkImageLayout srcImageLayout) {
     static uint32_t s_copyCount = 0;
     static VkImage s_lastSrcImage = VK_NULL_HANDLE;
     s_copyCount++;
@@ -206,15 +288,44 @@ SharedTexture* RND_Renderer::Layer3D::CopyColorToLayer(OpenXR::EyeSide side, VkC
             s_copyCount, side == OpenXR::EyeSide::LEFT ? "L" : "R", frameIdx, (void*)image);
     }
     m_currentFrameIdx = frameIdx;
-    m_textures[side][frameIdx]->CopyFromVkImage(copyCmdBuffer, image, srcImageLayout);
+    if (auto gpuTime = m_textures[side][frameIdx]->ConsumeCopyGpuTime()) {
+        VRManager::instance().XR->GetRenderer()->m_perfStats.AddGpuCopyTime(gpuTime.value());
+    }
+    if (AsyncCopyQueue* copyQueue = VRManager::instance().VK->GetCopyQueue()) {
+        copyQueue->Stage(cmdBuffer, copyBatch, image, m_textures[side][frameIdx].get(), side, (uint32_t)frameIdx);
+        return nullptr;
+    }
+    m_textures[side][frameIdx]->CopyFromVkImage(copyBatch, image, srcImageLayout);
     return m_textures[side][frameIdx].get();
 }
 
-SharedTexture* RND_Renderer::Layer3D::CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx, VkImageLayout srcImageLayout) {
-    m_depthTextures[side][frameIdx]->CopyFromVkImage(copyCmdBuffer, image, srcImageLayout);
+SharedTexture* RND_Renderer::Layer3D::CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer cmdBuffer, CopyBatch& copyBatch, VkImage image, long frameIdx, VkImageLayout srcImageLayout) {
+    if (auto gpuTime = m_depthTextures[side][frameIdx]->ConsumeCopyGpuTime()) {
+        VRManager::instance().XR->GetRenderer()->m_perfStats.AddGpuCopyTime(gpuTime.value());
+    }
+    m_depthReadbacks[side]->Record(copyBatch, image);
+    if (AsyncCopyQueue* copyQueue = VRManager::instance().VK->GetCopyQueue()) {
+        copyQueue->Stage(cmdBuffer, copyBatch, image, m_depthTextures[side][frameIdx].get(), side, (uint32_t)frameIdx);
+        return nullptr;
+    }
+    m_depthTextures[side][frameIdx]->CopyFromVkImage(copyBatch, image, srcImageLayout);
     return m_depthTextures[side][frameIdx].get();
 }
 
+uint64_t RND_Renderer::Layer3D::GetFenceLag(long frameIdx) const {
+    // amount of fence values that were issued but haven't been reached on the GPU yet
+    std::scoped_lock lock(m_texturesMutex);
+    uint64_t fenceLag = 0;
+    for (const auto* texture : { m_textures[OpenXR::EyeSide::LEFT][frameIdx].get(), m_textures[OpenXR::EyeSide::RIGHT][frameIdx].get(), m_depthTextures[OpenXR::EyeSide::LEFT][frameIdx].get(), m_depthTextures[OpenXR::EyeSide::RIGHT][frameIdx].get() }) {
+        const uint64_t issuedValue = texture->GetD3D12WaitValue();
+        const uint64_t completedValue = texture->d3d12GetCompletedFenceValue();
+        if (issuedValue > completedValue) {
+            fenceLag = std::max(fenceLag, issuedValue - completedValue);
+        }
+    }
+    return fenceLag;
+}
+
 void RND_Renderer::Layer3D::PrepareRendering(OpenXR::EyeSide side) {
     // Log::print("Preparing rendering for {} side", side == OpenXR::EyeSide::LEFT ? "left" : "right");
     m_swapchains[side]->PrepareRendering();
@@ -222,6 +333,15 @@ void RND_Renderer::Layer3D::PrepareRendering(OpenXR::EyeSide side) {
 }
 
 std::optional<std::array<XrView, 2>> RND_Renderer::UpdateViews(XrTime predictedDisplayTime) {
+    auto newViews = LocateViews(predictedDisplayTime);
+    if (!newViews.has_value())
+        return std::nullopt; // what should occur when the orientation is invalid? keep rendering using old values?
+
+    m_currViews = newViews;
+    return m_currViews;
+}
+
+std::optional<std::array<XrView, 2>> RND_Renderer::LocateViews(XrTime predictedDisplayTime) const {
     std::array newViews = { XrView{ XR_TYPE_VIEW }, XrView{ XR_TYPE_VIEW } };
     XrViewLocateInfo viewLocateInfo = { XR_TYPE_VIEW_LOCATE_INFO };
     viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
@@ -231,15 +351,79 @@ std::optional<std::array<XrView, 2>> RND_Renderer::UpdateViews(XrTime predictedD
     uint32_t viewCount = (uint32_t)newViews.size();
     checkXRResult(xrLocateViews(VRManager::instance().XR->m_session, &viewLocateInfo, &viewState, viewCount, &viewCount, newViews.data()), "Failed to get view information!");
     if ((viewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT) == 0)
-        return std::nullopt; // what should occur when the orientation is invalid? keep rendering using old values?
+        return std::nullopt;
 
     const float playerHeightOffsetMeters = CemuHooks::GetSettings().playerHeightSetting.getLE();
     for (auto& view : newViews) {
         view.pose.position.y += playerHeightOffsetMeters;
     }
+    return newViews;
+}
 
-    m_currViews = newViews;
-    return m_currViews;
+void RND_Renderer::LateLatchPoses(long frameIdx) {
+    // built locally and published in one go, the performance HUD reads it from Cemu's Vulkan thread
+    LateLatchedPoses latched = {};
+    auto publish = [&]() {
+        std::scoped_lock lock(m_lateLatchMutex);
+        m_lateLatchedPoses = latched;
+    };
+
+    const auto& renderViews = m_renderFrames[frameIdx].views;
+    if (!renderViews.has_value()) {
+        publish();
+        return;
+    }
+
+    auto latchedViews = LocateViews(m_frameState.predictedDisplayTime);
+    if (!latchedViews.has_value()) {
+        publish();
+        return;
+    }
+
+    for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        const XrPosef& renderPose = renderViews.value()[side].pose;
+        const XrPosef& latchedPose = latchedViews.value()[side].pose;
+        latched.views[side] = PoseDelta::Compute(ToGLM(renderPose.position), ToGLM(renderPose.orientation), ToGLM(latchedPose.position), ToGLM(latchedPose.orientation));
+    }
+
+    // compare against the raw controller poses of this frame, so that the lag of the pose filter isn't counted as latch error
+    const auto input = VRManager::instance().XR->m_input.load();
+    const float playerHeightOffsetMeters = CemuHooks::GetSettings().playerHeightSetting.getLE();
+    constexpr XrSpaceLocationFlags POSE_VALID_BITS = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+    for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        latched.hands[side] = std::nullopt;
+        if (!input.inGame.in_game || (input.inGame.poseLocation[side].locationFlags & POSE_VALID_BITS) != POSE_VALID_BITS)
+            continue;
+
+        XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
+        if (XR_FAILED(xrLocateSpace(VRManager::instance().XR->m_handSpaces[side], VRManager::instance().XR->m_stageSpace, m_frameState.predictedDisplayTime, &spaceLocation)))
+            continue;
+        if ((spaceLocation.locationFlags & POSE_VALID_BITS) != POSE_VALID_BITS)
+            continue;
+
+        spaceLocation.pose.position.y += playerHeightOffsetMeters;
+        const XrPosef& renderPose = input.inGame.poseLocation[side].pose;
+        latched.hands[side] = PoseDelta::Compute(ToGLM(renderPose.position), ToGLM(renderPose.orientation), ToGLM(spaceLocation.pose.position), ToGLM(spaceLocation.pose.orientation));
+    }
+
+    latched.valid = true;
+    publish();
+    m_perfStats.AddPoseError(glm::degrees(std::max(latched.views[OpenXR::EyeSide::LEFT].angleError, latched.views[OpenXR::EyeSide::RIGHT].angleError)));
+}
+
+void RND_Renderer::Layer3D::PollSwapchains() {
+    for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        m_swapchains[side]->PollImage();
+        m_depthSwapchains[side]->PollImage();
+    }
+}
+
+float RND_Renderer::Layer3D::GetSwapchainWaitMs() const {
+    float waitMs = 0.0f;
+    for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        waitMs += m_swapchains[side]->GetLastWaitMs() + m_depthSwapchains[side]->GetLastWaitMs();
+    }
+    return waitMs;
 }
 
 void RND_Renderer::Layer3D::StartRendering() {
@@ -263,6 +447,8 @@ void RND_Renderer::Layer3D::Render(OpenXR::EyeSide side, long frameIdx) {
     ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetCommandQueue();
     ID3D12CommandAllocator* allocator = VRManager::instance().D3D12->GetFrameAllocator();
 
+    // held until the context has submitted, since it waits on and signals the textures' fences when it does
+    std::scoped_lock lock(m_texturesMutex);
     RND_D3D12::CommandContext<false> renderSharedTexture(device, queue, allocator, [this, side, frameIdx](RND_D3D12::CommandContext<false>* context) {
         context->GetRecordList()->SetName(L"RenderSharedTexture");
         auto& texture = m_textures[side][frameIdx];
@@ -327,6 +513,8 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
     this->m_swapchains[OpenXR::EyeSide::RIGHT]->FinishRendering();
     this->m_depthSwapchains[OpenXR::EyeSide::RIGHT]->FinishRendering();
 
+    const std::array<DepthRange, 2> depthRanges = { UpdateDepthRange(OpenXR::EyeSide::LEFT), UpdateDepthRange(OpenXR::EyeSide::RIGHT) };
+
     // clang-format off
     m_projectionViews[OpenXR::EyeSide::LEFT] = {
         .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW,
@@ -356,10 +544,10 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
                 }
             },
         },
-        .minDepth = 0.0f,
-        .maxDepth = 1.0f,
-        .nearZ = CemuHooks::GetSettings().GetZNear(),
-        .farZ = CemuHooks::GetSettings().GetZFar(),
+        .minDepth = depthRanges[OpenXR::EyeSide::LEFT].minDepth,
+        .maxDepth = depthRanges[OpenXR::EyeSide::LEFT].maxDepth,
+        .nearZ = depthRanges[OpenXR::EyeSide::LEFT].nearZ,
+        .farZ = depthRanges[OpenXR::EyeSide::LEFT].farZ,
     };
     m_projectionViews[OpenXR::EyeSide::RIGHT] = {
         .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW,
@@ -389,17 +577,56 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
                 }
             },
         },
-        .minDepth = 0.0f,
-        .maxDepth = 1.0f,
-        .nearZ = CemuHooks::GetSettings().GetZNear(),
-        .farZ = CemuHooks::GetSettings().GetZFar(),
+        .minDepth = depthRanges[OpenXR::EyeSide::RIGHT].minDepth,
+        .maxDepth = depthRanges[OpenXR::EyeSide::RIGHT].maxDepth,
+        .nearZ = depthRanges[OpenXR::EyeSide::RIGHT].nearZ,
+        .farZ = depthRanges[OpenXR::EyeSide::RIGHT].farZ,
     };
     // clang-format on
     return m_projectionViews;
 }
 
+RND_Renderer::Layer3D::DepthRange RND_Renderer::Layer3D::UpdateDepthRange(OpenXR::EyeSide side) {
+    const float nearZ = CemuHooks::GetSettings().GetZNear();
+    const float farZ = CemuHooks::GetSettings().GetZFar();
+
+    // Resize() replaces the readbacks and resets their age on the Vulkan thread, the readback itself is reduced outside of the lock
+    std::shared_ptr<DepthReadback> readback;
+    {
+        std::scoped_lock lock(m_texturesMutex);
+        readback = m_depthReadbacks[side];
+    }
+    const std::optional<DepthAnalysis::Range> landedRange = readback->Poll();
+
+    DepthAnalysis::Range range;
+    {
+        std::scoped_lock lock(m_texturesMutex);
+        // a readback that was replaced in the meantime measured the old resolution
+        if (landedRange && readback == m_depthReadbacks[side]) {
+            m_measuredDepthRanges[side] = landedRange.value();
+            m_depthAnalysisAge[side] = 0;
+        }
+        else if (m_depthAnalysisAge[side] < MAX_DEPTH_ANALYSIS_AGE) {
+            m_depthAnalysisAge[side]++;
+        }
+        if (m_depthAnalysisAge[side] >= MAX_DEPTH_ANALYSIS_AGE) {
+            return { 0.0f, 1.0f, nearZ, farZ };
+        }
+        range = m_measuredDepthRanges[side];
+    }
+
+    // Depth values are linear in 1/distance, so a subrange of them still maps linearly between the distances at its ends.
+    // Submitting the tight range lets the runtime spend its depth precision on the depths that are actually in the scene.
+    const float nearDistance = std::max(nearZ, DepthAnalysis::LinearizeDepth(std::clamp(range.minDepth, 0.0f, 1.0f), nearZ, farZ) * DEPTH_RANGE_NEAR_MARGIN);
+    const float farDistance = range.maxDepth >= 1.0f ? farZ : std::min(farZ, DepthAnalysis::LinearizeDepth(std::max(range.maxDepth, 0.0f), nearZ, farZ) * DEPTH_RANGE_FAR_MARGIN);
+    if (farDistance <= nearDistance) {
+        return { 0.0f, 1.0f, nearZ, farZ };
+    }
+    return { DepthAnalysis::DistanceToDepth(nearDistance, nearZ, farZ), DepthAnalysis::DistanceToDepth(farDistance, nearZ, farZ), nearDistance, farDistance };
+}
+
 
-RND_Renderer::Layer2D::Layer2D(VkExtent2D extent) {
+RND_Renderer::Layer2D::Layer2D(SharedTexturePool& texturePool, VkExtent2D extent): m_texturePool(texturePool), m_extent(extent) {
     auto viewConfs = VRManager::instance().XR->GetViewConfigurations();
 
     this->m_presentPipeline = std::make_unique<RND_D3D12::PresentPipeline<false>>(VRManager::instance().XR->GetRenderer());
@@ -407,13 +634,8 @@ RND_Renderer::Layer2D::Layer2D(VkExtent2D extent) {
     // note: it's possible to make a swapchain that matches Cemu's internal resolution and let the headset downsample it, although I doubt there's a benefit
     this->m_swapchain = std::make_unique<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>(viewConfs[0].recommendedImageRectWidth, viewConfs[0].recommendedImageRectHeight, viewConfs[0].recommendedSwapchainSampleCount);
 
-    this->m_presentPipeline->BindSettings((float)this->m_swapchain->GetWidth(), (float)this->m_swapchain->GetHeight());
-
     // initialize textures
-    for (int i = 0; i < 2; ++i) {
-        this->m_textures[i] = std::make_unique<SharedTexture>(extent.width, extent.height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, D3D12Utils::ToDXGIFormat(VK_FORMAT_A2B10G10R10_UNORM_PACK32));
-        this->m_textures[i]->d3d12GetTexture()->SetName(L"Layer2D - Color Texture");
-    }
+    AcquireTextures(extent);
 
     ComPtr<ID3D12CommandAllocator> cmdAllocator;
     {
@@ -434,16 +656,41 @@ RND_Renderer::Layer2D::Layer2D(VkExtent2D extent) {
 
 RND_Renderer::Layer2D::~Layer2D() {
     m_swapchain.reset();
+    ReleaseTextures();
 }
 
-SharedTexture* RND_Renderer::Layer2D::CopyColorToLayer(VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx, VkImageLayout srcImageLayout) {
+void RND_Renderer::Layer2D::AcquireTextures(VkExtent2D extent) {
+    const auto colorKey = SharedTexturePool::MakeKey(extent, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
+    for (int i = 0; i < 2; ++i) {
+        this->m_textures[i] = m_texturePool.Acquire(colorKey, L"Layer2D - Color Texture");
+    }
+}
+
+void RND_Renderer::Layer2D::ReleaseTextures() {
+    for (int i = 0; i < 2; ++i) {
+        m_texturePool.Release(std::move(this->m_textures[i]));
+    }
+}
+
+void RND_Renderer::Layer2D::Resize(VkExtent2D extent) {
+    Log::print<INFO>("Resizing 2D layer textures from {}x{} to {}x{}", m_extent.width, m_extent.height, extent.width, extent.height);
+    std::scoped_lock lock(m_texturesMutex);
+    ReleaseTextures();
+    AcquireTextures(extent);
+    m_extent = extent;
+}
+
+SharedTexture* RND_Renderer::Layer2D::CopyColorToLayer(CopyBatch& copyBatch, VkImage image, long frameIdx, VkImageLayout srcImageLayout) {
     static uint32_t s_copyCount = 0;
     s_copyCount++;
     if (s_copyCount % 100 == 0) {
         Log::print<VERBOSE>("Layer2D::CopyColorToLayer #{} - frameIdx={}, srcImage={}", s_copyCount, frameIdx, (void*)image);
     }
     m_currentFrameIdx = frameIdx;
-    m_textures[frameIdx]->CopyFromVkImage(copyCmdBuffer, image, srcImageLayout);
+    if (auto gpuTime = m_textures[frameIdx]->ConsumeCopyGpuTime()) {
+        VRManager::instance().XR->GetRenderer()->m_perfStats.AddGpuCopyTime(gpuTime.value());
+    }
+    m_textures[frameIdx]->CopyFromVkImage(copyBatch, image, srcImageLayout);
     return m_textures[frameIdx].get();
 }
 
@@ -457,6 +704,8 @@ void RND_Renderer::Layer2D::Render(long frameIdx) {
     ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetCommandQueue();
     ID3D12CommandAllocator* allocator = VRManager::instance().D3D12->GetFrameAllocator();
 
+    // held until the context has submitted, since it waits on and signals the texture's fence when it does
+    std::scoped_lock lock(m_texturesMutex);
     RND_D3D12::CommandContext<false> renderSharedTexture(device, queue, allocator, [this, frameIdx](RND_D3D12::CommandContext<false>* context) {
         context->GetRecordList()->SetName(L"RenderSharedTexture");
 
@@ -497,37 +746,34 @@ void RND_Renderer::Layer2D::Render(long frameIdx) {
     });
 }
 
-std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTime predictedDisplayTime, long frameIdx) {
+void RND_Renderer::Layer2D::FinishRendering(XrTime predictedDisplayTime, long frameIdx, CompositionLayerArena& arena) {
     this->m_swapchain->FinishRendering();
 
-    XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
-    xrLocateSpace(VRManager::instance().XR->m_headSpace, VRManager::instance().XR->m_stageSpace, predictedDisplayTime, &spaceLocation);
-    glm::quat headOrientation = ToGLM(spaceLocation.pose.orientation);
-    glm::vec3 headPosition = ToGLM(spaceLocation.pose.position);
-
-    if (CemuHooks::GetSettings().UIFollowsLookingDirection()) {
-        m_currentOrientation = glm::slerp(m_currentOrientation, headOrientation, LERP_SPEED);
-        glm::vec3 forwardDirection = headOrientation * glm::vec3(0.0f, 0.0f, -1.0f);
-
-        // calculate new position forwards
-        glm::vec3 targetPosition = headPosition + (DISTANCE * forwardDirection);
+    // the head was usually already located for this display time when the actions were updated
+    const auto [headLocation, headVelocity] = VRManager::instance().XR->m_spaceRelations.Locate(SpaceRelationCache::HEAD, predictedDisplayTime);
+    XrSpaceLocation spaceLocation = headLocation;
 
-        // calculate rightward direction
-        glm::vec3 rightDirection = glm::normalize(glm::cross(forwardDirection, glm::vec3(0.0f, 1.0f, 0.0f)));
+    // the filter is stepped by the time between the predicted display times, so that it follows at the same speed at any frame rate
+    const float deltaSeconds = m_lastDisplayTime == 0 ? 0.0f : (float)((double)(predictedDisplayTime - m_lastDisplayTime) / 1'000'000'000.0);
+    m_lastDisplayTime = predictedDisplayTime;
 
-        // recalculate up direction using right and forward direction
-        glm::vec3 upDirection = glm::cross(rightDirection, forwardDirection);
-        glm::quat userFacingOrientation = glm::quatLookAt(forwardDirection, upDirection);
-
-        spaceLocation.pose.orientation = ToXR(userFacingOrientation);
-        spaceLocation.pose.position = ToXR(targetPosition);
+    if (CemuHooks::GetSettings().UIFollowsLookingDirection()) {
+        const glm::fvec3 angularVelocity = (headVelocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) ? ToGLM(headVelocity.angularVelocity) : glm::fvec3(0.0f);
+        const FollowFilter::Pose quadPose = m_followFilter.Update(ToGLM(headLocation.pose.position), ToGLM(headLocation.pose.orientation), angularVelocity, deltaSeconds);
+        spaceLocation.pose.orientation = ToXR(quadPose.orientation);
+        spaceLocation.pose.position = ToXR(quadPose.position);
     }
     else {
+        // start from the current view again once following is turned back on
+        m_followFilter.Reset();
         spaceLocation.pose.position.z -= DISTANCE;
         spaceLocation.pose.orientation = { 0.0f, 0.0f, 0.0f, 1.0f };
     }
 
-    const float aspectRatio = (float)this->m_textures[frameIdx]->d3d12GetTexture()->GetDesc().Width / (float)this->m_textures[frameIdx]->d3d12GetTexture()->GetDesc().Height;
+    const float aspectRatio = [this, frameIdx] {
+        std::scoped_lock lock(m_texturesMutex);
+        return (float)this->m_textures[frameIdx]->d3d12GetTexture()->GetDesc().Width / (float)this->m_textures[frameIdx]->d3d12GetTexture()->GetDesc().Height;
+    }();
 
     const float width = aspectRatio > 1.0f ? aspectRatio : 1.0f;
     const float height = aspectRatio <= 1.0f ? 1.0f / aspectRatio : 1.0f;
@@ -535,10 +781,8 @@ std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTim
     // todo: change space to head space if we want to follow the head
     constexpr float MENU_SIZE = 1.0f;
 
-    std::vector<XrCompositionLayerQuad> layers;
-
     // clang-format off
-    layers.push_back({
+    m_finishedQuad = XrCompositionLayerQuad{
         .type = XR_TYPE_COMPOSITION_LAYER_QUAD,
         .layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT,
         .space = VRManager::instance().XR->m_stageSpace,
@@ -555,17 +799,18 @@ std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTim
         },
         .pose = spaceLocation.pose,
         .size = { width * MENU_SIZE, height * MENU_SIZE }
-    });
+    };
     // clang-format on
+    arena.AddQuad(m_finishedQuad.value());
 
     // render layer twice to visualize the controller positions in debug mode
     auto inputs = VRManager::instance().XR->m_input.load();
 
     if (!(inputs.inGame.in_game && inputs.inGame.pose[OpenXR::EyeSide::LEFT].isActive && inputs.inGame.pose[OpenXR::EyeSide::RIGHT].isActive)) {
-        return layers;
+        return;
     }
 
-    return layers;
+    return;
 
     auto movePoseToHandPosition = [](XrPosef& inputPose) {
         glm::fquat modifiedRotation = ToGLM(inputPose.orientation);
@@ -578,10 +823,10 @@ std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTim
         inputPose.position = ToXR(modifiedPosition);
     };
 
-    if ((inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 1 || (inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) == 1) {
-        movePoseToHandPosition(inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].pose);
+    if ((inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::LEFT].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 1 || (inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::LEFT].locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) == 1) {
+        movePoseToHandPosition(inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::LEFT].pose);
         // clang-format off
-        layers.push_back({
+        arena.AddQuad({
             .type = XR_TYPE_COMPOSITION_LAYER_QUAD,
             .layerFlags = 0,
             .space = VRManager::instance().XR->m_stageSpace,
@@ -596,17 +841,17 @@ std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTim
                     }
                 }
             },
-            .pose = inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].pose,
+            .pose = inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::LEFT].pose,
             .size = { 0.15f, 0.15f }
         });
         // clang-format on
     }
 
-    if ((inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 1 || (inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) == 1) {
-        movePoseToHandPosition(inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].pose);
+    if ((inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::RIGHT].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 1 || (inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::RIGHT].locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) == 1) {
+        movePoseToHandPosition(inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::RIGHT].pose);
 
         // clang-format off
-        layers.push_back({
+        arena.AddQuad({
             .type = XR_TYPE_COMPOSITION_LAYER_QUAD,
             .layerFlags = 0,
             .space = VRManager::instance().XR->m_stageSpace,
@@ -621,11 +866,10 @@ std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTim
                     }
                 }
             },
-            .pose = inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].pose,
+            .pose = inputs.inGame.filteredPoseLocation[OpenXR::EyeSide::RIGHT].pose,
             .size = { 0.15f, 0.15f }
         });
         // clang-format on
     }
 
-    return layers;
 }
\ No newline at end of file
@@ -2,9 +2,20 @@
 
 #include "pch.h"
 #include "d3d12.h"
+#include "depth_readback.h"
 #include "openxr.h"
 #include "swapchain.h"
 #include "texture.h"
+#include "texture_pool.h"
+#include "transient_heap.h"
+#include "hooking/hook_profiler.h"
+#include "utils/depth_analysis.h"
+#include "utils/follow_filter.h"
+#include "utils/frame_ring.h"
+#include "utils/layer_arena.h"
+#include "utils/perf_stats.h"
+#include "utils/pose_delta.h"
+#include "utils/reprojection_fallback.h"
 
 class SharedTexture;
 
@@ -13,12 +24,12 @@ public:
     explicit RND_Renderer(XrSession xrSession);
     ~RND_Renderer();
 
+    // the graphic pack tags every frame with alternating indices, so two frames can be in flight
+    using FrameRingType = FrameRing<2>;
+
+    // resources of a frame, its progress is tracked by the frame ring
     struct RenderFrame {
         std::optional<std::array<XrView, 2>> views;
-        std::atomic_bool copiedColor[2] = { false, false };
-        std::atomic_bool copiedDepth[2] = { false, false };
-        std::atomic_bool copied2D = false;
-        std::atomic_bool presented3D = false;
 
         std::unique_ptr<VulkanTexture> mainFramebuffer;
         std::unique_ptr<VulkanTexture> hudFramebuffer;
@@ -31,17 +42,8 @@ public:
 
         bool ranMotionAnalysis[2] = { false, false };
 
-        bool Is3DComplete() const { return copiedColor[0] && copiedColor[1] && copiedDepth[0] && copiedDepth[1]; }
-        bool Is2DComplete() const { return copied2D; }
-
         void Reset() {
             views = std::nullopt;
-            copiedColor[0] = false;
-            copiedColor[1] = false;
-            copiedDepth[0] = false;
-            copiedDepth[1] = false;
-            copied2D = false;
-
             ranMotionAnalysis[0] = false;
             ranMotionAnalysis[1] = false;
         }
@@ -50,6 +52,18 @@ public:
     void StartFrame();
     void EndFrame();
     std::optional<std::array<XrView, 2>> UpdateViews(XrTime predictedDisplayTime);
+
+    // Poses are located again right before the layers are submitted. The layers are still submitted with the poses they were rendered with,
+    // but the difference with the newer prediction is kept here.
+    struct LateLatchedPoses {
+        bool valid = false;
+        std::array<PoseDelta, 2> views;
+        std::array<std::optional<PoseDelta>, 2> hands;
+    };
+    LateLatchedPoses GetLateLatchedPoses() const {
+        std::scoped_lock lock(m_lateLatchMutex);
+        return m_lateLatchedPoses;
+    }
     
     std::optional<std::array<XrView, 2>> GetPoses(long frameIdx = -1) const { 
         if (frameIdx != -1 && m_renderFrames[frameIdx].views.has_value()) return m_renderFrames[frameIdx].views;
@@ -86,43 +100,92 @@ public:
     };
 
     void On3DColorCopied(OpenXR::EyeSide side, long frameIdx) {
-        m_renderFrames[frameIdx].copiedColor[side] = true;
         if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        m_frameRing.MarkCaptured(frameIdx, side == OpenXR::EyeSide::LEFT ? FrameRingType::COLOR_LEFT : FrameRingType::COLOR_RIGHT);
     }
 
     void On3DDepthCopied(OpenXR::EyeSide side, long frameIdx) {
-        m_renderFrames[frameIdx].copiedDepth[side] = true;
         if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        m_frameRing.MarkCaptured(frameIdx, side == OpenXR::EyeSide::LEFT ? FrameRingType::DEPTH_LEFT : FrameRingType::DEPTH_RIGHT);
     }
 
     void On2DCopied(long frameIdx) {
-        m_renderFrames[frameIdx].copied2D = true;
+        m_frameRing.MarkCaptured(frameIdx, FrameRingType::HUD);
     }
 
+    bool Is3DColorCopied(OpenXR::EyeSide side, long frameIdx) const { return m_frameRing.IsCaptured(frameIdx, side == OpenXR::EyeSide::LEFT ? FrameRingType::COLOR_LEFT : FrameRingType::COLOR_RIGHT); }
+    bool Is3DDepthCopied(OpenXR::EyeSide side, long frameIdx) const { return m_frameRing.IsCaptured(frameIdx, side == OpenXR::EyeSide::LEFT ? FrameRingType::DEPTH_LEFT : FrameRingType::DEPTH_RIGHT); }
+    bool Is2DCopied(long frameIdx) const { return m_frameRing.IsCaptured(frameIdx, FrameRingType::HUD); }
+
     RenderFrame& GetFrame(long frameIdx) { return m_renderFrames[frameIdx]; }
     const RenderFrame& GetFrame(long frameIdx) const { return m_renderFrames[frameIdx]; }
 
     class Layer3D {
     public:
-        explicit Layer3D(VkExtent2D extent);
+        Layer3D(SharedTexturePool& texturePool, VkExtent2D extent);
         ~Layer3D();
 
-        SharedTexture* CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx, VkImageLayout srcImageLayout);
-        SharedTexture* CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx, VkImageLayout srcImageLayout);
+        // replaces the textures that Cemu's framebuffers are copied into, the old ones are returned to the pool
+        void Resize(VkExtent2D extent);
+        VkExtent2D GetExtent() const {
+            std::scoped_lock lock(m_texturesMutex);
+            return m_extent;
+        }
+
+        // returns the texture whose semaphores Cemu's submit has to wait on and signal, or nullptr if the copy queue takes care of that
+        SharedTexture* CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer cmdBuffer, CopyBatch& copyBatch, VkImage image, long frameIdx, VkImageLayout srcImageLayout);
+        SharedTexture* CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer cmdBuffer, CopyBatch& copyBatch, VkImage image, long frameIdx, VkImageLayout srcImageLayout);
         void PrepareRendering(OpenXR::EyeSide side);
+        // checks whether the swapchain images that were acquired at the end of the last frame are ready, without blocking
+        void PollSwapchains();
         void StartRendering();
+        // time that the last StartRendering() spent waiting on swapchain images
+        float GetSwapchainWaitMs() const;
         void Render(OpenXR::EyeSide side, long frameIdx);
         const std::array<XrCompositionLayerProjectionView, 2>& FinishRendering(long frameIdx);
+        // the views of the last FinishRendering(), their swapchains still hold the images that were released then
+        const std::array<XrCompositionLayerProjectionView, 2>& GetFinishedViews() const { return m_projectionViews; }
 
         float GetAspectRatio(OpenXR::EyeSide side) const { return m_swapchains[side]->GetWidth() / (float)m_swapchains[side]->GetHeight(); }
         long GetCurrentFrameIdx() const { return m_currentFrameIdx; }
+        uint64_t GetFenceLag(long frameIdx) const;
+
+        RND_D3D12::PresentFilter GetPresentFilter(OpenXR::EyeSide side) const { return m_presentPipelines[side]->GetLastFilter(); }
 
     private:
+        struct DepthRange {
+            float minDepth;
+            float maxDepth;
+            float nearZ;
+            float farZ;
+        };
+
+        void AcquireTextures(VkExtent2D extent);
+        void ReleaseTextures();
+        // analyzes the newest depth readback and returns the range of depths that's submitted alongside the depth swapchain
+        DepthRange UpdateDepthRange(OpenXR::EyeSide side);
+
+        // the depths are measured on a frame that's a few frames old, so the submitted range is widened by these factors to cover the movement since then
+        static constexpr float DEPTH_RANGE_NEAR_MARGIN = 0.75f;
+        static constexpr float DEPTH_RANGE_FAR_MARGIN = 1.5f;
+        // falls back to the full range if no readback has landed for this many frames, which has to be longer than DepthReadback::READBACK_INTERVAL
+        static constexpr uint32_t MAX_DEPTH_ANALYSIS_AGE = 10;
+
         std::array<std::unique_ptr<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>, 2> m_swapchains;
         std::array<std::unique_ptr<Swapchain<DXGI_FORMAT_D32_FLOAT>>, 2> m_depthSwapchains;
         std::array<std::unique_ptr<RND_D3D12::PresentPipeline<true>>, 2> m_presentPipelines;
+        // Resize() replaces the textures on Cemu's Vulkan thread while the PPC thread renders from them
+        // the Vulkan thread is the only one that replaces them, so its own copies don't need to lock
+        mutable std::mutex m_texturesMutex;
         std::array<std::array<std::unique_ptr<SharedTexture>, 2>, 2> m_textures;
         std::array<std::array<std::unique_ptr<SharedTexture>, 2>, 2> m_depthTextures;
+        SharedTexturePool& m_texturePool;
+        VkExtent2D m_extent;
+
+        // shared so that UpdateDepthRange() can poll a readback outside of the lock while Resize() replaces it
+        std::array<std::shared_ptr<DepthReadback>, 2> m_depthReadbacks;
+        std::array<DepthAnalysis::Range, 2> m_measuredDepthRanges = {};
+        std::array<uint32_t, 2> m_depthAnalysisAge = { MAX_DEPTH_ANALYSIS_AGE, MAX_DEPTH_ANALYSIS_AGE };
 
         std::array<XrCompositionLayerProjectionView, 2> m_projectionViews = {};
         std::array<XrCompositionLayerDepthInfoKHR, 2> m_projectionViewsDepthInfo = {};
@@ -132,29 +195,50 @@ public:
 
     class Layer2D {
     public:
-        explicit Layer2D(VkExtent2D extent);
+        Layer2D(SharedTexturePool& texturePool, VkExtent2D extent);
         ~Layer2D();
 
-        SharedTexture* CopyColorToLayer(VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx, VkImageLayout srcImageLayout);
+        // replaces the textures that Cemu's framebuffers are copied into, the old ones are returned to the pool
+        void Resize(VkExtent2D extent);
+        VkExtent2D GetExtent() const {
+            std::scoped_lock lock(m_texturesMutex);
+            return m_extent;
+        }
+
+        SharedTexture* CopyColorToLayer(CopyBatch& copyBatch, VkImage image, long frameIdx, VkImageLayout srcImageLayout);
         // AMD GPU FIX: With incrementing values, Vulkan signals odd values (1,3,5...), D3D12 signals even values (2,4,6...)
         // Texture is ready for D3D12 when Vulkan has signaled (odd value > 0)
         bool IsTextureReady(long frameIdx) const {
+            std::scoped_lock lock(m_texturesMutex);
             uint64_t lastSignal = m_textures[frameIdx]->GetLastSignalledValue();
             return lastSignal > 0 && (lastSignal % 2 == 1);
         };
+        void PollSwapchains() { m_swapchain->PollImage(); }
         void StartRendering() const;
+        float GetSwapchainWaitMs() const { return m_swapchain->GetLastWaitMs(); }
         void Render(long frameIdx);
-        std::vector<XrCompositionLayerQuad> FinishRendering(XrTime predictedDisplayTime, long frameIdx);
+        // adds the layer's quads to the arena
+        void FinishRendering(XrTime predictedDisplayTime, long frameIdx, CompositionLayerArena& arena);
+        // the quad of the last FinishRendering(), its swapchain still holds the image that was released then
+        const std::optional<XrCompositionLayerQuad>& GetFinishedQuad() const { return m_finishedQuad; }
         long GetCurrentFrameIdx() const { return m_currentFrameIdx; }
 
     private:
+        void AcquireTextures(VkExtent2D extent);
+        void ReleaseTextures();
+
         std::unique_ptr<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>> m_swapchain;
         std::unique_ptr<RND_D3D12::PresentPipeline<false>> m_presentPipeline;
+        // Resize() replaces the textures on Cemu's Vulkan thread while the PPC thread renders from them
+        mutable std::mutex m_texturesMutex;
         std::array<std::unique_ptr<SharedTexture>, 2> m_textures;
+        SharedTexturePool& m_texturePool;
+        VkExtent2D m_extent;
 
         static constexpr float DISTANCE = 2.0f;
-        static constexpr float LERP_SPEED = 0.05f;
-        glm::quat m_currentOrientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        FollowFilter m_followFilter = FollowFilter(FollowFilter::Settings{ .distance = DISTANCE });
+        XrTime m_lastDisplayTime = 0;
+        std::optional<XrCompositionLayerQuad> m_finishedQuad;
 
         long m_currentFrameIdx = 0;
     };
@@ -164,32 +248,48 @@ public:
         explicit ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uint32_t height, VkFormat format);
         ~ImGuiOverlay();
 
+        // recreates the framebuffers that Cemu's output is copied into/from at a new resolution
+        void Resize(VkCommandBuffer cb, uint32_t width, uint32_t height);
+
         bool ShouldBlockGameInput() { return ImGui::GetIO().WantCaptureKeyboard; }
 
         void BeginFrame(long frameIdx, bool renderBackground);
         // AMD GPU FIX: Added srcLayout parameter to specify the actual source image layout
-        static void Draw3DLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, float aspectRatio, long frameIdx, VkImageLayout srcLayout);
-        static void DrawHUDLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, long frameIdx, VkImageLayout srcLayout);
+        static void Draw3DLayerAsBackground(CopyBatch& copyBatch, VkImage srcImage, float aspectRatio, long frameIdx, VkImageLayout srcLayout);
+        static void DrawHUDLayerAsBackground(CopyBatch& copyBatch, VkImage srcImage, long frameIdx, VkImageLayout srcLayout);
         void Update();
         void Render();
         void DrawAndCopyToImage(VkCommandBuffer cb, VkImage destImage, long frameIdx);
+        void DrawPerformanceHUD();
 
     private:
+        void CreateFramebuffers(VkCommandBuffer cb, uint32_t width, uint32_t height);
+
         VkDescriptorPool m_descriptorPool;
         VkRenderPass m_renderPass;
+        VkFormat m_format;
+        std::unique_ptr<TransientTextureHeap> m_framebufferHeap;
 
         HWND m_cemuTopWindow = nullptr;
         HWND m_cemuRenderWindow = nullptr;
 
         VkSampler m_sampler = VK_NULL_HANDLE;
+
+        bool m_showPerformanceHUD = false;
+        bool m_performanceHUDKeyWasDown = false;
+        PerformanceStats::Snapshot m_perfSnapshot = {};
+        std::vector<HookProfiler::HookStats> m_hookStats;
     };
 
+    // declared before the layers so that it outlives them
+    SharedTexturePool m_texturePool;
     std::unique_ptr<Layer3D> m_layer3D;
     std::unique_ptr<Layer2D> m_layer2D;
     std::unique_ptr<ImGuiOverlay> m_imguiOverlay;
+    PerformanceStats m_perfStats;
 
     bool IsRendering3D(long frameIdx) {
-        return m_renderFrames[frameIdx].presented3D;
+        return m_frameRing.WasPresented3D(frameIdx);
     }
     bool IsRendering2D() {
         return m_presented2DLastFrame;
@@ -199,10 +299,26 @@ public:
     }
 
 protected:
+    std::optional<std::array<XrView, 2>> LocateViews(XrTime predictedDisplayTime) const;
+    void LateLatchPoses(long frameIdx);
+
+    static constexpr auto FRAME_STALL_THRESHOLD = std::chrono::milliseconds(500);
+
     XrSession m_session;
     XrFrameState m_frameState = { XR_TYPE_FRAME_STATE };
     std::optional<std::array<XrView, 2>> m_currViews;
-    std::array<RenderFrame, 2> m_renderFrames;
+    std::array<RenderFrame, FrameRingType::SIZE> m_renderFrames;
+    FrameRingType m_frameRing;
+    FrameRingType::Clock::time_point m_lastReportedStall = {};
+    LateLatchedPoses m_lateLatchedPoses;
+    mutable std::mutex m_lateLatchMutex;
+    // set by the ImGui overlay on Cemu's Vulkan thread, the late latch is only measured while the HUD is visible
+    std::atomic_bool m_performanceHUDVisible = false;
+    ReprojectionFallback m_reprojectionFallback;
+    CompositionLayerArena m_layerArena;
+    float m_lastSubmitCpuMs = 0.0f;
+    float m_startFrameCpuMs = 0.0f; // StartFrame() without the time spent blocked in xrWaitFrame
+    XrTime m_lastPredictedDisplayTime = 0;
 
     std::atomic_bool m_isInitialized = false;
     std::atomic_bool m_presented2DLastFrame = false;
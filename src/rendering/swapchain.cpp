@@ -50,16 +50,42 @@ Swapchain<T>::Swapchain(uint32_t width, uint32_t height, uint32_t sampleCount):
 
 template <DXGI_FORMAT T>
 void Swapchain<T>::PrepareRendering() {
+    if (m_imageState != ImageState::RELEASED)
+        return;
     checkXRResult(xrAcquireSwapchainImage(m_swapchain, NULL, &m_swapchainImageIdx), "Can't acquire OpenXR swapchain image!");
+    m_imageState = ImageState::ACQUIRED;
 }
 
 template <DXGI_FORMAT T>
-ID3D12Resource* Swapchain<T>::StartRendering() {
+bool Swapchain<T>::WaitImage(XrDuration timeout) {
     XrSwapchainImageWaitInfo waitSwapchainInfo = { XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
-    waitSwapchainInfo.timeout = XR_INFINITE_DURATION;
-    if (XrResult waitResult = xrWaitSwapchainImage(m_swapchain, &waitSwapchainInfo); waitResult == XR_TIMEOUT_EXPIRED || XR_FAILED(waitResult)) {
+    waitSwapchainInfo.timeout = timeout;
+    const XrResult waitResult = xrWaitSwapchainImage(m_swapchain, &waitSwapchainInfo);
+    if (waitResult == XR_TIMEOUT_EXPIRED && timeout != XR_INFINITE_DURATION)
+        return false;
+    if (waitResult == XR_TIMEOUT_EXPIRED || XR_FAILED(waitResult)) {
         checkXRResult(waitResult, "Failed to wait for swapchain image!");
     }
+    m_imageState = ImageState::READY;
+    return true;
+}
+
+template <DXGI_FORMAT T>
+void Swapchain<T>::PollImage() {
+    if (m_imageState == ImageState::ACQUIRED) {
+        WaitImage(0);
+    }
+}
+
+template <DXGI_FORMAT T>
+ID3D12Resource* Swapchain<T>::StartRendering() {
+    PrepareRendering();
+    m_lastWaitMs = 0.0f;
+    if (m_imageState == ImageState::ACQUIRED) {
+        const auto waitStart = std::chrono::steady_clock::now();
+        WaitImage(XR_INFINITE_DURATION);
+        m_lastWaitMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    }
     return m_swapchainTextures[m_swapchainImageIdx].Get();
 }
 
@@ -67,6 +93,10 @@ template <DXGI_FORMAT T>
 void Swapchain<T>::FinishRendering() {
     XrSwapchainImageReleaseInfo releaseSwapchainInfo = { XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
     checkXRResult(xrReleaseSwapchainImage(m_swapchain, &releaseSwapchainInfo), "Failed to release swapchain image!");
+    m_imageState = ImageState::RELEASED;
+
+    // acquire the next image right away, so that the runtime has the whole frame to make it available
+    PrepareRendering();
 }
 
 template <DXGI_FORMAT T>
@@ -6,10 +6,24 @@ public:
     Swapchain(uint32_t width, uint32_t height, uint32_t sampleCount);
     ~Swapchain();
 
+    // The next image is acquired right after the previous one was released, and whether it's ready can be polled early in the frame.
+    // That way the (possibly blocking) wait in StartRendering() usually finds the image ready, instead of serializing with the copies.
+    enum class ImageState {
+        RELEASED, // no image is acquired
+        ACQUIRED, // acquired, but the runtime might still be reading from it
+        READY // waited on, can be rendered to
+    };
+
     void PrepareRendering();
+    // checks whether the acquired image became ready without blocking
+    void PollImage();
     ID3D12Resource* StartRendering();
     void FinishRendering();
 
+    ImageState GetImageState() const { return m_imageState; }
+    // time that the last StartRendering() was blocked waiting on the image
+    float GetLastWaitMs() const { return m_lastWaitMs; }
+
     XrSwapchain GetHandle() const { return m_swapchain; };
     ID3D12Resource* GetTexture() const { return m_swapchainTextures[m_swapchainImageIdx].Get(); };
 
@@ -25,4 +39,9 @@ private:
 
     std::vector<ComPtr<ID3D12Resource>> m_swapchainTextures;
     uint32_t m_swapchainImageIdx = 0;
+    ImageState m_imageState = ImageState::RELEASED;
+    float m_lastWaitMs = 0.0f;
+
+    // returns whether the image became ready within the timeout
+    bool WaitImage(XrDuration timeout);
 };
\ No newline at end of file
@@ -117,90 +117,64 @@ void BaseVulkanTexture::vkClearDepth(VkCommandBuffer cmdBuffer, float depth, uin
     dispatch->CmdClearDepthStencilImage(cmdBuffer, m_vkImage, m_vkCurrLayout, &clearValue, 1, &range);
 }
 
-void BaseVulkanTexture::vkCopyFromImage(VkCommandBuffer cmdBuffer, VkImage srcImage, VkImageLayout srcLayout) {
-    auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
+void BaseVulkanTexture::vkCopyFromImage(CopyBatch& batch, VkImage srcImage, VkImageLayout srcLayout, VkImageLayout finalLayout) {
     VkImageAspectFlags aspectMask = GetAspectMask();
 
     // AMD GPU FIX: If srcLayout is already TRANSFER_SRC_OPTIMAL, the caller has managed the transition
     // (e.g., via ensureSrcLayout in framebuffer.cpp). Skip internal transitions to avoid conflicts.
-    bool callerManagedLayout = (srcLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-
-    if (!callerManagedLayout) {
-        // Pre-copy barrier: transition source to TRANSFER_SRC_OPTIMAL
-        VkImageMemoryBarrier2 srcPreBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-        srcPreBarrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-        srcPreBarrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
-        srcPreBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        srcPreBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-        srcPreBarrier.oldLayout = srcLayout;
-        srcPreBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        srcPreBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcPreBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcPreBarrier.image = srcImage;
-        // AMD GPU FIX: Use VK_REMAINING to cover all subresources
-        srcPreBarrier.subresourceRange = {
-            .aspectMask = aspectMask,
-            .baseMipLevel = 0,
-            .levelCount = VK_REMAINING_MIP_LEVELS,
-            .baseArrayLayer = 0,
-            .layerCount = VK_REMAINING_ARRAY_LAYERS
-        };
-
-        VkDependencyInfo preBarrierDep = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-        preBarrierDep.imageMemoryBarrierCount = 1;
-        preBarrierDep.pImageMemoryBarriers = &srcPreBarrier;
-        dispatch->CmdPipelineBarrier2(cmdBuffer, &preBarrierDep);
+    if (srcLayout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        batch.PreCopy().Transition(srcImage, aspectMask, srcLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        batch.PostCopy().Transition(srcImage, aspectMask, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, srcLayout);
     }
+    batch.PreCopy().Transition(m_vkImage, aspectMask, m_vkCurrLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    batch.PostCopy().Transition(m_vkImage, aspectMask, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, finalLayout);
+    m_vkCurrLayout = finalLayout;
+
+    batch.AddCopy({
+        .srcImage = srcImage,
+        .dstImage = m_vkImage,
+        .region = {
+            .srcSubresource = { aspectMask, 0, 0, 1 },
+            .srcOffset = { 0, 0, 0 },
+            .dstSubresource = { aspectMask, 0, 0, 1 },
+            .dstOffset = { 0, 0, 0 },
+            .extent = {
+                .width = m_width,
+                .height = m_height,
+                .depth = 1
+            }
+        },
+        .timestampPool = VK_NULL_HANDLE
+    });
+}
 
-    const VkImageCopy region = {
-        .srcSubresource = { aspectMask, 0, 0, 1 },
-        .srcOffset = { 0, 0, 0 },
-        .dstSubresource = { aspectMask, 0, 0, 1 },
-        .dstOffset = { 0, 0, 0 },
-        .extent = {
-            .width = m_width,
-            .height = m_height,
-            .depth = 1
-        }
-    };
+VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, bool disableAlphaThroughSwizzling): BaseVulkanTexture(width, height, format), m_disableAlphaThroughSwizzling(disableAlphaThroughSwizzling) {
+    const auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
 
-    dispatch->CmdCopyImage(cmdBuffer, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    CreateImage(usage);
 
-    if (!callerManagedLayout) {
-        // Post-copy barrier: transition source back to original layout
-        VkImageMemoryBarrier2 srcPostBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-        srcPostBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        srcPostBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-        srcPostBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-        srcPostBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
-        srcPostBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        srcPostBarrier.newLayout = srcLayout;
-        srcPostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcPostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcPostBarrier.image = srcImage;
-        // AMD GPU FIX: Use VK_REMAINING to cover all subresources
-        srcPostBarrier.subresourceRange = {
-            .aspectMask = aspectMask,
-            .baseMipLevel = 0,
-            .levelCount = VK_REMAINING_MIP_LEVELS,
-            .baseArrayLayer = 0,
-            .layerCount = VK_REMAINING_ARRAY_LAYERS
-        };
-
-        VkDependencyInfo postBarrierDep = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-        postBarrierDep.imageMemoryBarrierCount = 1;
-        postBarrierDep.pImageMemoryBarriers = &srcPostBarrier;
-        dispatch->CmdPipelineBarrier2(cmdBuffer, &postBarrierDep);
-    }
+    VkMemoryRequirements memRequirements = GetMemoryRequirements();
+    uint32_t memoryTypeIndex = VRManager::instance().VK->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+    checkVkResult(dispatch->AllocateMemory(VRManager::instance().VK->GetDevice(), &allocInfo, nullptr, &m_vkMemory), "Failed to allocate memory!");
+
+    checkVkResult(dispatch->BindImageMemory(VRManager::instance().VK->GetDevice(), m_vkImage, m_vkMemory, 0), "Failed to bind memory to image!");
+
+    CreateImageView();
 }
 
-VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, bool disableAlphaThroughSwizzling): BaseVulkanTexture(width, height, format) {
-    const auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
+VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, bool disableAlphaThroughSwizzling, DeferredMemory): BaseVulkanTexture(width, height, format), m_disableAlphaThroughSwizzling(disableAlphaThroughSwizzling) {
+    CreateImage(usage);
+}
 
+void VulkanTexture::CreateImage(VkImageUsageFlags usage) {
     VkImageCreateInfo imageCreateInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
     imageCreateInfo.flags = 0;
     imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageCreateInfo.format = format;
+    imageCreateInfo.format = m_vkFormat;
     imageCreateInfo.extent = {
         .width = m_width,
         .height = m_height,
@@ -215,29 +189,19 @@ VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, V
     imageCreateInfo.queueFamilyIndexCount = 0;
     imageCreateInfo.pQueueFamilyIndices = nullptr;
     imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    checkVkResult(dispatch->CreateImage(VRManager::instance().VK->GetDevice(), &imageCreateInfo, nullptr, &m_vkImage), "Failed to create image!");
-
-    VkMemoryRequirements memRequirements;
-    dispatch->GetImageMemoryRequirements(VRManager::instance().VK->GetDevice(), m_vkImage, &memRequirements);
-
-    uint32_t memoryTypeIndex = VRManager::instance().VK->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = memoryTypeIndex;
-    checkVkResult(dispatch->AllocateMemory(VRManager::instance().VK->GetDevice(), &allocInfo, nullptr, &m_vkMemory), "Failed to allocate memory!");
-
-    checkVkResult(dispatch->BindImageMemory(VRManager::instance().VK->GetDevice(), m_vkImage, m_vkMemory, 0), "Failed to bind memory to image!");
+    checkVkResult(VRManager::instance().VK->GetDeviceDispatch()->CreateImage(VRManager::instance().VK->GetDevice(), &imageCreateInfo, nullptr, &m_vkImage), "Failed to create image!");
+}
 
+void VulkanTexture::CreateImageView() {
     VkImageViewCreateInfo imageViewCreateInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
     imageViewCreateInfo.image = m_vkImage;
     imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    imageViewCreateInfo.format = format;
+    imageViewCreateInfo.format = m_vkFormat;
     imageViewCreateInfo.components = {
         .r = VK_COMPONENT_SWIZZLE_IDENTITY,
         .g = VK_COMPONENT_SWIZZLE_IDENTITY,
         .b = VK_COMPONENT_SWIZZLE_IDENTITY,
-        .a = disableAlphaThroughSwizzling ? VK_COMPONENT_SWIZZLE_ONE : VK_COMPONENT_SWIZZLE_IDENTITY
+        .a = m_disableAlphaThroughSwizzling ? VK_COMPONENT_SWIZZLE_ONE : VK_COMPONENT_SWIZZLE_IDENTITY
     };
     imageViewCreateInfo.subresourceRange = {
         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -246,7 +210,20 @@ VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, V
         .baseArrayLayer = 0,
         .layerCount = 1
     };
-    checkVkResult(dispatch->CreateImageView(VRManager::instance().VK->GetDevice(), &imageViewCreateInfo, nullptr, &m_vkImageView), "Failed to create image view!");
+    checkVkResult(VRManager::instance().VK->GetDeviceDispatch()->CreateImageView(VRManager::instance().VK->GetDevice(), &imageViewCreateInfo, nullptr, &m_vkImageView), "Failed to create image view!");
+}
+
+VkMemoryRequirements VulkanTexture::GetMemoryRequirements() const {
+    VkMemoryRequirements memRequirements;
+    VRManager::instance().VK->GetDeviceDispatch()->GetImageMemoryRequirements(VRManager::instance().VK->GetDevice(), m_vkImage, &memRequirements);
+    return memRequirements;
+}
+
+void VulkanTexture::BindMemory(VkDeviceMemory memory, VkDeviceSize offset) {
+    checkAssert(m_vkMemory == VK_NULL_HANDLE && m_vkImageView == VK_NULL_HANDLE, "Texture already has memory bound!");
+    // note: m_vkMemory stays empty since the memory is owned (and freed) by whoever bound it
+    checkVkResult(VRManager::instance().VK->GetDeviceDispatch()->BindImageMemory(VRManager::instance().VK->GetDevice(), m_vkImage, memory, offset), "Failed to bind memory to image!");
+    CreateImageView();
 }
 
 VulkanTexture::~VulkanTexture() {
@@ -259,15 +236,27 @@ VulkanTexture::~VulkanTexture() {
     }
 }
 
-VulkanFramebuffer::VulkanFramebuffer(uint32_t width, uint32_t height, VkFormat format, VkRenderPass renderPass): VulkanTexture(width, height, format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+VulkanFramebuffer::VulkanFramebuffer(uint32_t width, uint32_t height, VkFormat format, VkRenderPass renderPass): VulkanTexture(width, height, format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT), m_renderPass(renderPass) {
+    CreateFramebuffer();
+}
+
+VulkanFramebuffer::VulkanFramebuffer(uint32_t width, uint32_t height, VkFormat format, VkRenderPass renderPass, DeferredMemory deferred): VulkanTexture(width, height, format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false, deferred), m_renderPass(renderPass) {
+}
+
+void VulkanFramebuffer::BindMemory(VkDeviceMemory memory, VkDeviceSize offset) {
+    VulkanTexture::BindMemory(memory, offset);
+    CreateFramebuffer();
+}
+
+void VulkanFramebuffer::CreateFramebuffer() {
     const auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
 
     VkFramebufferCreateInfo framebufferInfo = { VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
-    framebufferInfo.renderPass = renderPass;
+    framebufferInfo.renderPass = m_renderPass;
     framebufferInfo.attachmentCount = 1;
     framebufferInfo.pAttachments = &m_vkImageView;
-    framebufferInfo.width = width;
-    framebufferInfo.height = height;
+    framebufferInfo.width = m_width;
+    framebufferInfo.height = m_height;
     framebufferInfo.layers = 1;
     checkVkResult(dispatch->CreateFramebuffer(dispatch->Device, &framebufferInfo, nullptr, &m_framebuffer), "Failed to create framebuffer!");
 }
@@ -458,18 +447,53 @@ SharedTexture::SharedTexture(uint32_t width, uint32_t height, VkFormat vkFormat,
     importSemaphoreInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_D3D12_FENCE_BIT;
     importSemaphoreInfo.handle = m_d3d12FenceHandle;
     checkVkResult(dispatch->ImportSemaphoreWin32HandleKHR(VRManager::instance().VK->GetDevice(), &importSemaphoreInfo), "Failed to import semaphore for shared texture!");
+
+    // create timestamp queries to measure how long the copy takes on the GPU
+    if (VRManager::instance().VK->SupportsTimestamps()) {
+        VkQueryPoolCreateInfo queryPoolCreateInfo = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolCreateInfo.queryCount = 2;
+        checkVkResult(dispatch->CreateQueryPool(VRManager::instance().VK->GetDevice(), &queryPoolCreateInfo, nullptr, &m_vkTimestampPool), "Failed to create timestamp query pool for shared texture!");
+    }
 }
 
 SharedTexture::~SharedTexture() {
     if (m_vkSemaphore != VK_NULL_HANDLE)
         VRManager::instance().VK->GetDeviceDispatch()->DestroySemaphore(VRManager::instance().VK->GetDevice(), m_vkSemaphore, nullptr);
+    if (m_vkTimestampPool != VK_NULL_HANDLE)
+        VRManager::instance().VK->GetDeviceDispatch()->DestroyQueryPool(VRManager::instance().VK->GetDevice(), m_vkTimestampPool, nullptr);
 }
 
-void SharedTexture::CopyFromVkImage(VkCommandBuffer cmdBuffer, VkImage srcImage, VkImageLayout srcImageLayout) {
+std::optional<float> SharedTexture::ConsumeCopyGpuTime() {
+    if (m_vkTimestampPool == VK_NULL_HANDLE || !m_timestampsPending)
+        return std::nullopt;
+
+    // don't wait for the results, a copy that hasn't finished yet is simply skipped
+    std::array<uint64_t, 2> timestamps = {};
+    VkResult result = VRManager::instance().VK->GetDeviceDispatch()->GetQueryPoolResults(VRManager::instance().VK->GetDevice(), m_vkTimestampPool, 0, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+        return std::nullopt;
+
+    m_timestampsPending = false;
+    return (float)((double)(timestamps[1] - timestamps[0]) * VRManager::instance().VK->GetTimestampPeriod() / 1000000.0);
+}
+
+void SharedTexture::ResetForReuse() {
+    // Vulkan signalled last, so D3D12 signals in place of the render that never happened
+    // the pool only hands out textures whose fence already reached that Vulkan signal, so this doesn't have to wait on anything
+    if (m_fenceCounter.load() % 2 == 1) {
+        d3d12SignalFence(GetD3D12SignalValue());
+    }
+    m_fenceLastSignaledValue = 0;
+    m_fenceLastAwaitedValue = 0;
+    // the timestamps belong to a copy at the old resolution
+    m_timestampsPending = false;
+}
+
+void SharedTexture::CopyFromVkImage(CopyBatch& batch, VkImage srcImage, VkImageLayout srcImageLayout) {
     static uint32_t s_copyCount = 0;
     s_copyCount++;
 
-    auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
     // AMD GPU FIX: Use GetAspectMask() from Vulkan format, NOT D3D12 format detection.
     // D3D12 depth resources are created as typeless (e.g., DXGI_FORMAT_R32_TYPELESS),
     // which would incorrectly return false for IsDepthFormat().
@@ -497,126 +521,28 @@ void SharedTexture::CopyFromVkImage(VkCommandBuffer cmdBuffer, VkImage srcImage,
             desc.Width, desc.Height, (int)srcImageLayout, (int)m_vkCurrLayout, callerManagedLayout);
     }
 
-    // Pre-copy barrier: destination always needs transition, source only if not caller-managed
-    VkImageMemoryBarrier2 dstBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-    dstBarrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-    dstBarrier.srcAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
-    dstBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-    dstBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-    dstBarrier.oldLayout = m_vkCurrLayout;
-    dstBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    dstBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    dstBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    dstBarrier.image = this->m_vkImage;
-    // AMD GPU FIX: Use VK_REMAINING to cover all subresources
-    dstBarrier.subresourceRange = {
-        .aspectMask = aspectMask,
-        .baseMipLevel = 0,
-        .levelCount = VK_REMAINING_MIP_LEVELS,
-        .baseArrayLayer = 0,
-        .layerCount = VK_REMAINING_ARRAY_LAYERS
-    };
-
-    if (callerManagedLayout) {
-        // Only transition destination
-        VkDependencyInfo preCopyDep = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-        preCopyDep.imageMemoryBarrierCount = 1;
-        preCopyDep.pImageMemoryBarriers = &dstBarrier;
-        dispatch->CmdPipelineBarrier2(cmdBuffer, &preCopyDep);
-    } else {
-        // Transition both source and destination
-        VkImageMemoryBarrier2 srcBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-        srcBarrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-        srcBarrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
-        srcBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        srcBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-        srcBarrier.oldLayout = srcImageLayout;
-        srcBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        srcBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcBarrier.image = srcImage;
-        // AMD GPU FIX: Use VK_REMAINING to cover all subresources
-        srcBarrier.subresourceRange = {
-            .aspectMask = aspectMask,
-            .baseMipLevel = 0,
-            .levelCount = VK_REMAINING_MIP_LEVELS,
-            .baseArrayLayer = 0,
-            .layerCount = VK_REMAINING_ARRAY_LAYERS
-        };
-
-        VkImageMemoryBarrier2 barriers[2] = { srcBarrier, dstBarrier };
-        VkDependencyInfo preCopyDep = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-        preCopyDep.imageMemoryBarrierCount = 2;
-        preCopyDep.pImageMemoryBarriers = barriers;
-        dispatch->CmdPipelineBarrier2(cmdBuffer, &preCopyDep);
+    // source is restored to its ORIGINAL layout for Cemu, destination ends up in GENERAL for the D3D12 side
+    if (!callerManagedLayout) {
+        batch.PreCopy().Transition(srcImage, aspectMask, srcImageLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        batch.PostCopy().Transition(srcImage, aspectMask, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, srcImageLayout);
     }
+    batch.PreCopy().Transition(this->m_vkImage, aspectMask, m_vkCurrLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    batch.PostCopy().Transition(this->m_vkImage, aspectMask, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    m_vkCurrLayout = VK_IMAGE_LAYOUT_GENERAL;
 
-    m_vkCurrLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-
-    VkImageCopy copyRegion = {
-        .srcSubresource = { aspectMask, 0, 0, 1 },
-        .srcOffset = { 0, 0, 0 },
-        .dstSubresource = { aspectMask, 0, 0, 1 },
-        .dstOffset = { 0, 0, 0 },
-        .extent = { (uint32_t)this->m_d3d12Texture->GetDesc().Width, (uint32_t)this->m_d3d12Texture->GetDesc().Height, 1 }
-    };
-
-    // Copy using the correct layouts
-    dispatch->CmdCopyImage(cmdBuffer, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, this->m_vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
-
-    // Post-copy barrier: destination always transitions to GENERAL, source only if not caller-managed
-    VkImageMemoryBarrier2 dstPostBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-    dstPostBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-    dstPostBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-    dstPostBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-    dstPostBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
-    dstPostBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    dstPostBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    dstPostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    dstPostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    dstPostBarrier.image = this->m_vkImage;
-    // AMD GPU FIX: Use VK_REMAINING to cover all subresources
-    dstPostBarrier.subresourceRange = {
-        .aspectMask = aspectMask,
-        .baseMipLevel = 0,
-        .levelCount = VK_REMAINING_MIP_LEVELS,
-        .baseArrayLayer = 0,
-        .layerCount = VK_REMAINING_ARRAY_LAYERS
-    };
-
-    if (callerManagedLayout) {
-        // Only transition destination - source stays in TRANSFER_SRC_OPTIMAL for caller to restore
-        VkDependencyInfo postCopyDep = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-        postCopyDep.imageMemoryBarrierCount = 1;
-        postCopyDep.pImageMemoryBarriers = &dstPostBarrier;
-        dispatch->CmdPipelineBarrier2(cmdBuffer, &postCopyDep);
-    } else {
-        // Transition both source and destination
-        VkImageMemoryBarrier2 srcPostBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-        srcPostBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        srcPostBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-        srcPostBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-        srcPostBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
-        srcPostBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        srcPostBarrier.newLayout = srcImageLayout;  // Restore to ORIGINAL layout for Cemu
-        srcPostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcPostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        srcPostBarrier.image = srcImage;
-        // AMD GPU FIX: Use VK_REMAINING to cover all subresources
-        srcPostBarrier.subresourceRange = {
-            .aspectMask = aspectMask,
-            .baseMipLevel = 0,
-            .levelCount = VK_REMAINING_MIP_LEVELS,
-            .baseArrayLayer = 0,
-            .layerCount = VK_REMAINING_ARRAY_LAYERS
-        };
-
-        VkImageMemoryBarrier2 postBarriers[2] = { srcPostBarrier, dstPostBarrier };
-        VkDependencyInfo postCopyDep = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-        postCopyDep.imageMemoryBarrierCount = 2;
-        postCopyDep.pImageMemoryBarriers = postBarriers;
-        dispatch->CmdPipelineBarrier2(cmdBuffer, &postCopyDep);
+    batch.AddCopy({
+        .srcImage = srcImage,
+        .dstImage = this->m_vkImage,
+        .region = {
+            .srcSubresource = { aspectMask, 0, 0, 1 },
+            .srcOffset = { 0, 0, 0 },
+            .dstSubresource = { aspectMask, 0, 0, 1 },
+            .dstOffset = { 0, 0, 0 },
+            .extent = { (uint32_t)this->m_d3d12Texture->GetDesc().Width, (uint32_t)this->m_d3d12Texture->GetDesc().Height, 1 }
+        },
+        .timestampPool = m_vkTimestampPool
+    });
+    if (m_vkTimestampPool != VK_NULL_HANDLE) {
+        m_timestampsPending = true;
     }
-
-    m_vkCurrLayout = VK_IMAGE_LAYOUT_GENERAL;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "utils/barrier_batch.h"
+
 class SharedTexture;
 
 class BaseVulkanTexture {
@@ -16,8 +18,9 @@ public:
     void vkClearDepth(VkCommandBuffer cmdBuffer, float depth, uint32_t stencil = 0);
     void vkCopyToImage(VkCommandBuffer cmdBuffer, VkImage dstImage);
     // AMD GPU FIX: srcLayout parameter to specify the actual source image layout
-    // If srcLayout is TRANSFER_SRC_OPTIMAL, assume caller has already transitioned and skip internal transitions
-    void vkCopyFromImage(VkCommandBuffer cmdBuffer, VkImage srcImage, VkImageLayout srcLayout = VK_IMAGE_LAYOUT_GENERAL);
+    // If srcLayout is TRANSFER_SRC_OPTIMAL, assume caller has already transitioned (e.g. through the ImageLayoutTracker) and skip internal transitions
+    // The copy and its transitions are only added to the batch, CopyBatch::Record() records them
+    void vkCopyFromImage(CopyBatch& batch, VkImage srcImage, VkImageLayout srcLayout, VkImageLayout finalLayout);
     uint32_t GetWidth() const { return m_width; }
     uint32_t GetHeight() const { return m_height; }
     VkFormat GetFormat() const { return m_vkFormat; }
@@ -35,24 +38,42 @@ protected:
 class VulkanTexture : public BaseVulkanTexture {
     friend class VulkanFramebuffer;
 public:
+    // creates the image without any memory, it can only be used once BindMemory() has been called (e.g. by a TransientTextureHeap)
+    struct DeferredMemory {};
+
     VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, bool disableAlphaThroughSwizzling);
     VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage): VulkanTexture(width, height, format, usage, false) {
     }
+    VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, bool disableAlphaThroughSwizzling, DeferredMemory);
     ~VulkanTexture() override;
 
+    VkMemoryRequirements GetMemoryRequirements() const;
+    // binds memory that the texture doesn't own and creates the image view
+    virtual void BindMemory(VkDeviceMemory memory, VkDeviceSize offset);
+
     VkImageView GetImageView() const { return m_vkImageView; }
 
 private:
+    void CreateImage(VkImageUsageFlags usage);
+    void CreateImageView();
+
     VkImageView m_vkImageView = VK_NULL_HANDLE;
+    bool m_disableAlphaThroughSwizzling;
 };
 
 class VulkanFramebuffer : public VulkanTexture {
 public:
     VulkanFramebuffer(uint32_t width, uint32_t height, VkFormat format, VkRenderPass renderPass);
+    VulkanFramebuffer(uint32_t width, uint32_t height, VkFormat format, VkRenderPass renderPass, DeferredMemory);
     ~VulkanFramebuffer() override;
 
+    void BindMemory(VkDeviceMemory memory, VkDeviceSize offset) override;
+
     VkFramebuffer GetFramebuffer() const { return m_framebuffer; }
 private:
+    void CreateFramebuffer();
+
+    VkRenderPass m_renderPass;
     VkFramebuffer m_framebuffer = VK_NULL_HANDLE;
 };
 
@@ -70,6 +91,7 @@ public:
 
     uint64_t GetLastSignalledValue() const { return m_fenceLastSignaledValue; }
     uint64_t GetLastAwaitedValue() const { return m_fenceLastAwaitedValue; }
+    uint64_t d3d12GetCompletedFenceValue() const { return m_d3d12Fence->GetCompletedValue(); }
 
 protected:
     void SetLastSignalledValue(uint64_t value) {
@@ -115,8 +137,11 @@ public:
     ~SharedTexture() override;
 
     // srcImageLayout: the ACTUAL current layout of srcImage (e.g., from Cemu's CmdClearColorImage hook)
-    void CopyFromVkImage(VkCommandBuffer cmdBuffer, VkImage srcImage, VkImageLayout srcImageLayout = VK_IMAGE_LAYOUT_GENERAL);
+    // The copy and its transitions are only added to the batch, CopyBatch::Record() records them
+    void CopyFromVkImage(CopyBatch& batch, VkImage srcImage, VkImageLayout srcImageLayout);
     const VkSemaphore& GetSemaphore() const { return m_vkSemaphore; }
+    // GPU time in milliseconds of the last recorded copy, or nothing if it hasn't finished executing (or was already consumed)
+    std::optional<float> ConsumeCopyGpuTime();
 
     // AMD GPU FIX: Timeline semaphores require strictly increasing values.
     // Instead of ping-ponging between 0 and 1, we use a monotonically increasing counter.
@@ -139,6 +164,10 @@ public:
     // Get the value D3D12 should signal (increments counter)
     uint64_t GetD3D12SignalValue() { return ++m_fenceCounter; }
 
+    // A texture that comes back out of the pool has to start out like a new one, with D3D12 having signalled last and nothing copied into it yet.
+    // Otherwise a copy that was never presented before it was released would shift which side signals the odd values.
+    void ResetForReuse();
+
     const VkSemaphore& GetSemaphoreForSignal(uint64_t dbg_SignalTo = 0) {
         SetLastSignalledValue(dbg_SignalTo);
         return m_vkSemaphore;
@@ -152,4 +181,7 @@ private:
     VkSemaphore m_vkSemaphore = VK_NULL_HANDLE;
     std::atomic_bool m_activeOperation = false;
     std::atomic<uint64_t> m_fenceCounter{0};  // Monotonically increasing fence value
+
+    VkQueryPool m_vkTimestampPool = VK_NULL_HANDLE;
+    bool m_timestampsPending = false;
 };
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "texture_pool.h"
+#include "instance.h"
+
+
+SharedTexturePool::SharedTexturePool() {
+    m_worker = std::jthread([this](std::stop_token stopToken) { WorkerThread(stopToken); });
+}
+
+SharedTexturePool::~SharedTexturePool() {
+    // stop the worker before destroying its textures
+    m_worker.request_stop();
+    m_workerCondition.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+
+    std::lock_guard lock(m_mutex);
+    for (auto& deferred : m_deferred) {
+        deferred.destroy();
+    }
+    m_deferred.clear();
+    m_retiring.clear();
+    m_free.clear();
+}
+
+SharedTexturePool::Key SharedTexturePool::GetKey(const SharedTexture& texture) {
+    return { texture.GetWidth(), texture.GetHeight(), texture.GetFormat(), texture.d3d12GetFormat() };
+}
+
+std::unique_ptr<SharedTexture> SharedTexturePool::CreateTexture(const Key& key) {
+    // note: textures are created in D3D12_RESOURCE_STATE_COMMON, which is the state that the cross-API sharing requires
+    return std::make_unique<SharedTexture>(key.width, key.height, key.vkFormat, key.d3d12Format);
+}
+
+std::unique_ptr<SharedTexture> SharedTexturePool::Acquire(const Key& key, const wchar_t* name) {
+    std::unique_ptr<SharedTexture> texture;
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = std::ranges::find(m_free, key, &PooledTexture::key); it != m_free.end()) {
+            texture = std::move(it->texture);
+            m_free.erase(it);
+        }
+    }
+
+    if (!texture) {
+        Log::print<VERBOSE>("Allocating shared texture {}x{} (format {}) since none is available in the pool", key.width, key.height, key.vkFormat);
+        texture = CreateTexture(key);
+    }
+    else {
+        texture->ResetForReuse();
+    }
+    texture->d3d12GetTexture()->SetName(name);
+    return texture;
+}
+
+void SharedTexturePool::Release(std::unique_ptr<SharedTexture> texture) {
+    if (!texture)
+        return;
+
+    std::lock_guard lock(m_mutex);
+    const Key key = GetKey(*texture);
+    m_retiring.emplace_back(PooledTexture{ key, std::move(texture), m_frame, m_nextSequence++ });
+}
+
+void SharedTexturePool::Preallocate(const Key& key, uint32_t count) {
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = std::ranges::find(m_preallocations, key, &std::pair<Key, uint32_t>::first); it != m_preallocations.end()) {
+            it->second = std::max(it->second, count);
+        }
+        else {
+            m_preallocations.emplace_back(key, count);
+        }
+    }
+    m_workerCondition.notify_one();
+}
+
+void SharedTexturePool::DeferDestruction(std::function<void()> destroy) {
+    std::lock_guard lock(m_mutex);
+    m_deferred.emplace_back(DeferredDestruction{ std::move(destroy), m_nextSequence++ });
+}
+
+void SharedTexturePool::Update() {
+    // textures are destroyed outside of the lock, since that can take a while
+    std::vector<std::unique_ptr<SharedTexture>> destroyedTextures;
+    std::vector<DeferredDestruction> destroyedResources;
+    {
+        std::lock_guard lock(m_mutex);
+        m_frame++;
+
+        // a texture has retired once the last fence value that was issued for it has been reached
+        std::erase_if(m_retiring, [this](PooledTexture& pooled) {
+            if (m_frame - pooled.frame < RETIRE_FRAMES)
+                return false;
+            if (pooled.texture->d3d12GetCompletedFenceValue() < pooled.texture->GetD3D12WaitValue())
+                return false;
+            m_free.emplace_back(PooledTexture{ pooled.key, std::move(pooled.texture), m_frame });
+            return true;
+        });
+
+        std::erase_if(m_free, [this, &destroyedTextures](PooledTexture& pooled) {
+            if (m_frame - pooled.frame < MAX_IDLE_FRAMES)
+                return false;
+            destroyedTextures.emplace_back(std::move(pooled.texture));
+            return true;
+        });
+
+        // the textures retire in any order, so a deferred destruction has to wait for the oldest one that's still retiring
+        uint64_t oldestRetiring = UINT64_MAX;
+        for (const PooledTexture& pooled : m_retiring) {
+            oldestRetiring = std::min(oldestRetiring, pooled.sequence);
+        }
+        std::erase_if(m_deferred, [oldestRetiring, &destroyedResources](DeferredDestruction& deferred) {
+            if (oldestRetiring < deferred.sequence)
+                return false;
+            destroyedResources.emplace_back(std::move(deferred));
+            return true;
+        });
+    }
+
+    for (auto& deferred : destroyedResources) {
+        deferred.destroy();
+    }
+    if (!destroyedTextures.empty()) {
+        Log::print<VERBOSE>("Destroyed {} shared textures that weren't used for {} frames", destroyedTextures.size(), MAX_IDLE_FRAMES);
+    }
+}
+
+size_t SharedTexturePool::GetFreeCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_free.size();
+}
+
+size_t SharedTexturePool::GetRetiringCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_retiring.size();
+}
+
+void SharedTexturePool::WorkerThread(std::stop_token stopToken) {
+    while (!stopToken.stop_requested()) {
+        Key key;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_workerCondition.wait(lock, stopToken, [this] { return !m_preallocations.empty(); }))
+                return;
+
+            auto& [preallocKey, count] = m_preallocations.front();
+            const size_t freeCount = std::ranges::count(m_free, preallocKey, &PooledTexture::key);
+            if (freeCount >= count) {
+                m_preallocations.erase(m_preallocations.begin());
+                continue;
+            }
+            key = preallocKey;
+        }
+
+        // creating the texture (and its shared handles) is the slow part, so it's done without holding the lock
+        std::unique_ptr<SharedTexture> texture = CreateTexture(key);
+
+        std::lock_guard lock(m_mutex);
+        m_free.emplace_back(PooledTexture{ key, std::move(texture), m_frame });
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "texture.h"
+#include "utils/d3d12_utils.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Reuses the shared textures that the layers copy Cemu's framebuffers into, since creating them (along with their D3D12 shared handles) is expensive.
+// Released textures are only reused or destroyed once the GPU is done with them, so that a resolution change never has to wait on the GPU.
+// Textures for an upcoming resolution can be preallocated on a worker thread, unused textures are destroyed after a while.
+class SharedTexturePool {
+public:
+    // a shared texture's Vulkan usage is derived from its format, so the formats are enough to tell whether it's compatible
+    struct Key {
+        uint32_t width;
+        uint32_t height;
+        VkFormat vkFormat;
+        DXGI_FORMAT d3d12Format;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    static Key MakeKey(VkExtent2D extent, VkFormat vkFormat) { return { extent.width, extent.height, vkFormat, D3D12Utils::ToDXGIFormat(vkFormat) }; }
+
+    SharedTexturePool();
+    ~SharedTexturePool();
+
+    // returns a free texture with the same key, or creates one if there's none
+    std::unique_ptr<SharedTexture> Acquire(const Key& key, const wchar_t* name);
+    // the texture can still be in use by either the Vulkan or D3D12 side, so it only becomes available again once it has retired
+    void Release(std::unique_ptr<SharedTexture> texture);
+    // creates textures on the worker thread until there are at least count free textures for the key
+    void Preallocate(const Key& key, uint32_t count);
+    // Runs a callback once every texture that was released before it has retired, for resources that aren't pooled but are used by the same frames as those textures.
+    // Their fences are what the GPU signals once it's done with those frames, so the resources are destroyed as soon as that happened instead of after a guessed amount of frames.
+    void DeferDestruction(std::function<void()> destroy);
+
+    // should be called once per frame, retires released textures and destroys textures that weren't used for a while
+    void Update();
+
+    size_t GetFreeCount() const;
+    size_t GetRetiringCount() const;
+
+private:
+    // released textures are only checked after this many frames, since their copy might still be waiting for Cemu to submit it
+    static constexpr uint64_t RETIRE_FRAMES = 3;
+    // free textures that weren't acquired for this many frames are destroyed
+    static constexpr uint64_t MAX_IDLE_FRAMES = 600;
+
+    struct PooledTexture {
+        Key key;
+        std::unique_ptr<SharedTexture> texture;
+        uint64_t frame; // frame at which it was released or became free
+        uint64_t sequence = 0; // order in which the texture was released relative to the deferred destructions
+    };
+    struct DeferredDestruction {
+        std::function<void()> destroy;
+        uint64_t sequence;
+    };
+
+    static Key GetKey(const SharedTexture& texture);
+    static std::unique_ptr<SharedTexture> CreateTexture(const Key& key);
+    void WorkerThread(std::stop_token stopToken);
+
+    mutable std::mutex m_mutex;
+    std::vector<PooledTexture> m_free;
+    std::vector<PooledTexture> m_retiring;
+    std::vector<DeferredDestruction> m_deferred;
+    std::vector<std::pair<Key, uint32_t>> m_preallocations;
+    uint64_t m_frame = 0;
+    uint64_t m_nextSequence = 0;
+
+    std::condition_variable_any m_workerCondition;
+    std::jthread m_worker;
+};
@@ -0,0 +1,51 @@
+#include "transient_heap.h"
+#include "instance.h"
+
+
+TransientTextureHeap::~TransientTextureHeap() {
+    for (const Heap& heap : m_heaps) {
+        if (heap.memory != VK_NULL_HANDLE)
+            VRManager::instance().VK->GetDeviceDispatch()->FreeMemory(VRManager::instance().VK->GetDevice(), heap.memory, nullptr);
+    }
+}
+
+void TransientTextureHeap::Add(VulkanTexture* texture) {
+    checkAssert(std::ranges::none_of(m_heaps, [](const Heap& heap) { return heap.memory != VK_NULL_HANDLE; }), "Can't add textures to a transient heap that has already been allocated!");
+
+    const VkMemoryRequirements memRequirements = texture->GetMemoryRequirements();
+    const uint32_t memoryTypeIndex = VRManager::instance().VK->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    auto it = std::ranges::find(m_heaps, memoryTypeIndex, &Heap::memoryTypeIndex);
+    if (it == m_heaps.end()) {
+        it = m_heaps.insert(m_heaps.end(), Heap{ memoryTypeIndex, 0, VK_NULL_HANDLE });
+    }
+    const VkDeviceSize offset = (it->size + memRequirements.alignment - 1) / memRequirements.alignment * memRequirements.alignment;
+    it->size = offset + memRequirements.size;
+    m_placements.emplace_back(Placement{ texture, (uint32_t)std::distance(m_heaps.begin(), it), offset });
+}
+
+void TransientTextureHeap::Allocate() {
+    const auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
+    const VkDevice device = VRManager::instance().VK->GetDevice();
+
+    for (Heap& heap : m_heaps) {
+        VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+        allocInfo.allocationSize = heap.size;
+        allocInfo.memoryTypeIndex = heap.memoryTypeIndex;
+        checkVkResult(dispatch->AllocateMemory(device, &allocInfo, nullptr, &heap.memory), "Failed to allocate transient texture heap!");
+    }
+
+    for (const Placement& placement : m_placements) {
+        placement.texture->BindMemory(m_heaps[placement.heap].memory, placement.offset);
+    }
+
+    Log::print<INFO>("Allocated {} transient textures in {} heap(s) using {:.1f} MiB", m_placements.size(), m_heaps.size(), GetAllocatedSize() / (1024.0 * 1024.0));
+}
+
+uint64_t TransientTextureHeap::GetAllocatedSize() const {
+    uint64_t size = 0;
+    for (const Heap& heap : m_heaps) {
+        size += heap.size;
+    }
+    return size;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "texture.h"
+
+// Backs the textures of the overlay's frames with one VkDeviceMemory allocation per memory type instead of one per texture.
+// Every texture gets its own range of the allocation, both frames can be in flight at once and their framebuffers are all used while the overlay is drawn, so nothing is aliased.
+class TransientTextureHeap {
+public:
+    TransientTextureHeap() = default;
+    ~TransientTextureHeap();
+
+    // the texture has to be created with VulkanTexture::DeferredMemory
+    void Add(VulkanTexture* texture);
+    // allocates the heaps and binds the memory of all added textures
+    void Allocate();
+
+    uint64_t GetAllocatedSize() const;
+
+private:
+    struct Heap {
+        uint32_t memoryTypeIndex;
+        VkDeviceSize size;
+        VkDeviceMemory memory;
+    };
+    struct Placement {
+        VulkanTexture* texture;
+        uint32_t heap;
+        VkDeviceSize offset;
+    };
+
+    std::vector<Heap> m_heaps;
+    std::vector<Placement> m_placements;
+};
@@ -15,6 +15,9 @@ RND_Vulkan::RND_Vulkan(VkInstance vkInstance, VkPhysicalDevice vkPhysDevice, VkD
 
     VkPhysicalDeviceProperties props{};
     m_instanceDispatch->GetPhysicalDeviceProperties(vkPhysDevice, &props);
+    if (props.limits.timestampComputeAndGraphics) {
+        m_timestampPeriod = props.limits.timestampPeriod;
+    }
 
     uint64_t localVramBytes = 0;
     for (uint32_t i = 0; i < m_memoryProperties.memoryProperties.memoryHeapCount; ++i) {
@@ -27,12 +30,24 @@ RND_Vulkan::RND_Vulkan(VkInstance vkInstance, VkPhysicalDevice vkPhysDevice, VkD
     if (localVramBytes > 0) {
         Log::print<INFO>("GPU VRAM (device local): {:.2f} GiB", double(localVramBytes) / (1024.0 * 1024.0 * 1024.0));
     }
+
+    if (AsyncCopyQueue::IsQueueReserved()) {
+        m_copyQueue = std::make_unique<AsyncCopyQueue>(vkDevice, m_deviceDispatch);
+    }
 }
 
 RND_Vulkan::~RND_Vulkan() {
 }
 
 uint32_t RND_Vulkan::FindMemoryType(uint32_t memoryTypeBitsRequirement, VkMemoryPropertyFlags requirementsMask) {
+    if (const auto memoryType = TryFindMemoryType(memoryTypeBitsRequirement, requirementsMask)) {
+        return memoryType.value();
+    }
+    checkAssert(false, "Failed to find suitable memory type");
+    return 0;
+}
+
+std::optional<uint32_t> RND_Vulkan::TryFindMemoryType(uint32_t memoryTypeBitsRequirement, VkMemoryPropertyFlags requirementsMask) const {
     // AMD GPU FIX: Use actual memoryTypeCount instead of VK_MAX_MEMORY_TYPES to avoid reading uninitialized data
     const uint32_t memoryTypeCount = m_memoryProperties.memoryProperties.memoryTypeCount;
     for (uint32_t i = 0; i < memoryTypeCount; i++) {
@@ -44,8 +59,7 @@ uint32_t RND_Vulkan::FindMemoryType(uint32_t memoryTypeBitsRequirement, VkMemory
             return i;
         }
     }
-    checkAssert(false, "Failed to find suitable memory type");
-    return 0;
+    return std::nullopt;
 }
 
 
@@ -1,4 +1,5 @@
 #pragma once
+#include "copy_queue.h"
 #include "openxr.h"
 #include "texture.h"
 
@@ -9,19 +10,30 @@ public:
     ~RND_Vulkan();
 
     uint32_t FindMemoryType(uint32_t memoryTypeBitsRequirement, VkMemoryPropertyFlags requirementsMask);
+    // returns nothing instead of failing if no memory type has all of the properties
+    std::optional<uint32_t> TryFindMemoryType(uint32_t memoryTypeBitsRequirement, VkMemoryPropertyFlags requirementsMask) const;
+    VkMemoryPropertyFlags GetMemoryTypeProperties(uint32_t memoryTypeIndex) const { return m_memoryProperties.memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags; }
     VkInstance GetInstance() { return m_instance; }
     VkDevice GetDevice() { return m_device; }
     VkPhysicalDevice GetPhysicalDevice() { return m_physicalDevice; }
+    bool SupportsTimestamps() const { return m_timestampPeriod > 0.0f; }
+    float GetTimestampPeriod() const { return m_timestampPeriod; }
 
     const vkroots::VkInstanceDispatch* GetInstanceDispatch() const { return m_instanceDispatch; }
     const vkroots::VkPhysicalDeviceDispatch* GetPhysicalDeviceDispatch() const { return m_physicalDeviceDispatch; }
     const vkroots::VkDeviceDispatch* GetDeviceDispatch() const { return m_deviceDispatch; }
+    // nullptr if the device has no separate queue for the eye copies
+    AsyncCopyQueue* GetCopyQueue() const { return m_copyQueue.get(); }
+    // the copy queue has to be destroyed before the device, since it waits for its copies to finish
+    void DestroyCopyQueue() { m_copyQueue.reset(); }
 
 private:
     VkInstance m_instance;
     VkPhysicalDevice m_physicalDevice;
     VkDevice m_device;
     VkPhysicalDeviceMemoryProperties2 m_memoryProperties = {};
+    float m_timestampPeriod = 0.0f; // nanoseconds per timestamp tick, 0 if graphics queues can't write timestamps
+    std::unique_ptr<AsyncCopyQueue> m_copyQueue;
 
     // todo: use these with caution
     const vkroots::VkInstanceDispatch* m_instanceDispatch;
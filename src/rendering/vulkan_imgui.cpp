@@ -2,7 +2,7 @@
 #include "vulkan.h"
 #include "hooking/entity_debugger.h"
 
-RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uint32_t height, VkFormat format) {
+RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uint32_t height, VkFormat format): m_format(format) {
     ImGui::CreateContext();
     ImPlot3D::CreateContext();
     ImPlot::CreateContext();
@@ -119,11 +119,6 @@ RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uin
     };
     checkAssert(ImGui_ImplVulkan_Init(&init_info), "Failed to initialize ImGui");
 
-    auto* renderer = VRManager::instance().XR->GetRenderer();
-    for (int i = 0; i < 2; ++i) {
-        renderer->GetFrame(i).imguiFramebuffer = std::make_unique<VulkanFramebuffer>(width, height, format, m_renderPass);
-    }
-
     Log::print<VERBOSE>("Initializing font textures for ImGui...");
     ImGui_ImplVulkan_CreateFontsTexture();
 
@@ -161,24 +156,7 @@ RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uin
     }
     m_cemuRenderWindow = iteratedHwnd;
 
-    for (int i = 0; i < 2; ++i) {
-        auto& frame = renderer->GetFrame(i);
-        frame.mainFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, false);
-        frame.hudFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, false);
-        frame.hudWithoutAlphaFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, true);
-
-        frame.mainFramebuffer->vkPipelineBarrier(cb);
-        frame.mainFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-        frame.mainFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
-
-        frame.hudFramebuffer->vkPipelineBarrier(cb);
-        frame.hudFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-        frame.hudFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
-
-        frame.hudWithoutAlphaFramebuffer->vkPipelineBarrier(cb);
-        frame.hudWithoutAlphaFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-        frame.hudWithoutAlphaFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
-    }
+    CreateFramebuffers(cb, width, height);
 
     // create sampler
     VkSamplerCreateInfo samplerInfo = { VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
@@ -198,6 +176,8 @@ RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uin
     samplerInfo.minLod = -1000.0f;
     samplerInfo.maxLod = 1000.0f;
     checkVkResult(VRManager::instance().VK->GetDeviceDispatch()->CreateSampler(VRManager::instance().VK->GetDevice(), &samplerInfo, nullptr, &m_sampler), "Failed to create sampler for ImGui");
+
+    m_showPerformanceHUD = CemuHooks::GetSettings().ShowDebugOverlay();
 }
 
 RND_Renderer::ImGuiOverlay::~ImGuiOverlay() {
@@ -233,6 +213,71 @@ RND_Renderer::ImGuiOverlay::~ImGuiOverlay() {
     ImGui::DestroyContext();
 }
 
+void RND_Renderer::ImGuiOverlay::CreateFramebuffers(VkCommandBuffer cb, uint32_t width, uint32_t height) {
+    auto* renderer = VRManager::instance().XR->GetRenderer();
+    m_framebufferHeap = std::make_unique<TransientTextureHeap>();
+    for (int i = 0; i < 2; ++i) {
+        auto& frame = renderer->GetFrame(i);
+        frame.imguiFramebuffer = std::make_unique<VulkanFramebuffer>(width, height, m_format, m_renderPass, VulkanTexture::DeferredMemory{});
+        frame.mainFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, false, VulkanTexture::DeferredMemory{});
+        frame.hudFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, false, VulkanTexture::DeferredMemory{});
+        frame.hudWithoutAlphaFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, true, VulkanTexture::DeferredMemory{});
+
+        m_framebufferHeap->Add(frame.mainFramebuffer.get());
+        m_framebufferHeap->Add(frame.hudFramebuffer.get());
+        m_framebufferHeap->Add(frame.hudWithoutAlphaFramebuffer.get());
+        m_framebufferHeap->Add(frame.imguiFramebuffer.get());
+    }
+    m_framebufferHeap->Allocate();
+
+    for (int i = 0; i < 2; ++i) {
+        auto& frame = renderer->GetFrame(i);
+
+        frame.mainFramebuffer->vkPipelineBarrier(cb);
+        frame.mainFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
+        frame.mainFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
+
+        frame.hudFramebuffer->vkPipelineBarrier(cb);
+        frame.hudFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
+        frame.hudFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
+
+        frame.hudWithoutAlphaFramebuffer->vkPipelineBarrier(cb);
+        frame.hudWithoutAlphaFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
+        frame.hudWithoutAlphaFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
+    }
+}
+
+void RND_Renderer::ImGuiOverlay::Resize(VkCommandBuffer cb, uint32_t width, uint32_t height) {
+    auto* renderer = VRManager::instance().XR->GetRenderer();
+    for (int i = 0; i < 2; ++i) {
+        auto& frame = renderer->GetFrame(i);
+
+        // commands that use the old framebuffers (and the descriptor sets that sample them) might not have executed yet
+        renderer->m_texturePool.DeferDestruction([
+            mainFramebuffer = std::shared_ptr<VulkanTexture>(std::move(frame.mainFramebuffer)),
+            hudFramebuffer = std::shared_ptr<VulkanTexture>(std::move(frame.hudFramebuffer)),
+            hudWithoutAlphaFramebuffer = std::shared_ptr<VulkanTexture>(std::move(frame.hudWithoutAlphaFramebuffer)),
+            imguiFramebuffer = std::shared_ptr<VulkanFramebuffer>(std::move(frame.imguiFramebuffer)),
+            descriptorSets = std::array{ frame.mainFramebufferDS, frame.hudFramebufferDS, frame.hudWithoutAlphaFramebufferDS }
+        ]() {
+            // the descriptor sets are already freed along with the descriptor pool if the overlay was destroyed in the meantime
+            if (ImGui::GetCurrentContext() == nullptr)
+                return;
+            for (VkDescriptorSet descriptorSet : descriptorSets) {
+                if (descriptorSet != VK_NULL_HANDLE)
+                    ImGui_ImplVulkan_RemoveTexture(descriptorSet);
+            }
+        });
+        frame.mainFramebufferDS = VK_NULL_HANDLE;
+        frame.hudFramebufferDS = VK_NULL_HANDLE;
+        frame.hudWithoutAlphaFramebufferDS = VK_NULL_HANDLE;
+    }
+    renderer->m_texturePool.DeferDestruction([framebufferHeap = std::shared_ptr<TransientTextureHeap>(std::move(m_framebufferHeap))]() {});
+
+    ImGui::GetIO().DisplaySize = ImVec2((float)width, (float)height);
+    CreateFramebuffers(cb, width, height);
+}
+
 constexpr ImGuiWindowFlags FULLSCREEN_WINDOW_FLAGS = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoBringToFrontOnFocus;
 
 void RND_Renderer::ImGuiOverlay::BeginFrame(long frameIdx, bool renderBackground) {
@@ -347,41 +392,122 @@ void RND_Renderer::ImGuiOverlay::BeginFrame(long frameIdx, bool renderBackground
         VRManager::instance().Hooks->m_entityDebugger->DrawEntityInspector();
         VRManager::instance().Hooks->DrawDebugOverlays();
     }
+
+    if (m_showPerformanceHUD) {
+        DrawPerformanceHUD();
+    }
+    VRManager::instance().XR->GetRenderer()->m_performanceHUDVisible = m_showPerformanceHUD;
+}
+
+void RND_Renderer::ImGuiOverlay::DrawPerformanceHUD() {
+    VRManager::instance().XR->GetRenderer()->m_perfStats.TakeSnapshot(m_perfSnapshot);
+    const auto& counters = m_perfSnapshot.counters;
+
+    static std::array<float, PerformanceStats::PLOT_BUCKETS> s_bucketIndices = [] {
+        std::array<float, PerformanceStats::PLOT_BUCKETS> indices = {};
+        for (size_t i = 0; i < indices.size(); ++i) {
+            indices[i] = (float)i;
+        }
+        return indices;
+    }();
+
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.75f);
+    if (ImGui::Begin("Performance", &m_showPerformanceHUD, ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing)) {
+        ImGui::Text("Frames: %llu   Dropped: %llu   Duplicated: %llu   Repeated: %llu", counters.frames, counters.droppedFrames, counters.duplicatedFrames, counters.repeatedFrames);
+        ImGui::Text("Fence Lag: %llu (max %llu)", counters.fenceLag, counters.maxFenceLag);
+
+        if (auto& layer3D = VRManager::instance().XR->GetRenderer()->m_layer3D) {
+            ImGui::Text("Present Filter: %s", RND_D3D12::GetPresentFilterName(layer3D->GetPresentFilter(OpenXR::EyeSide::LEFT)));
+        }
+
+        const auto lateLatchedPoses = VRManager::instance().XR->GetRenderer()->GetLateLatchedPoses();
+        if (lateLatchedPoses.valid) {
+            ImGui::Text("Late Latch: head %.1f mm / %.2f deg", lateLatchedPoses.views[OpenXR::EyeSide::LEFT].positionError * 1000.0f, glm::degrees(lateLatchedPoses.views[OpenXR::EyeSide::LEFT].angleError));
+            for (auto side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+                if (const auto& hand = lateLatchedPoses.hands[side]) {
+                    ImGui::SameLine();
+                    ImGui::Text("  %s hand %.1f mm / %.2f deg", side == OpenXR::EyeSide::LEFT ? "left" : "right", hand->positionError * 1000.0f, glm::degrees(hand->angleError));
+                }
+            }
+        }
+
+        for (size_t i = 0; i < (size_t)PerformanceStats::Graph::COUNT; ++i) {
+            const auto& plot = m_perfSnapshot.plots[i];
+            const char* name = PerformanceStats::GetGraphName((PerformanceStats::Graph)i);
+
+            ImGui::Text("%-14s avg %6.2f %s   min %6.2f   max %6.2f", name, plot.summary.avg, PerformanceStats::GetGraphUnit((PerformanceStats::Graph)i), plot.summary.min, plot.summary.max);
+            if (plot.count == 0) {
+                continue;
+            }
+
+            ImGui::PushID((int)i);
+            if (ImPlot::BeginPlot("##perf", ImVec2(-1, 70), ImPlotFlags_CanvasOnly | ImPlotFlags_NoInputs)) {
+                ImPlot::SetupAxes(nullptr, nullptr, ImPlotAxisFlags_NoDecorations, ImPlotAxisFlags_AutoFit | ImPlotAxisFlags_NoLabel);
+                ImPlot::SetupAxisLimits(ImAxis_X1, 0.0, (double)(plot.count - 1), ImPlotCond_Always);
+                // min/max of each bucket is shaded so that short spikes remain visible
+                ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.35f);
+                ImPlot::PlotShaded(name, s_bucketIndices.data(), plot.min.data(), plot.max.data(), (int)plot.count);
+                ImPlot::PlotLine(name, s_bucketIndices.data(), plot.avg.data(), (int)plot.count);
+                ImPlot::EndPlot();
+            }
+            ImGui::PopID();
+        }
+
+        if (ImGui::CollapsingHeader("Hooks")) {
+            HookProfiler::GetStats(m_hookStats);
+            std::ranges::sort(m_hookStats, std::greater<>(), &HookProfiler::HookStats::frameTimeUs);
+
+            if (ImGui::Button("Dump to CSV")) {
+                HookProfiler::DumpToCSV("BetterVR_hooks.csv");
+            }
+
+            if (ImGui::BeginTable("##hooks", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Hook", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Calls/s");
+                ImGui::TableSetupColumn("Avg (us)");
+                ImGui::TableSetupColumn("Max (us)");
+                ImGui::TableSetupColumn("Frame (us)");
+                ImGui::TableHeadersRow();
+                for (const auto& hook : m_hookStats) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(hook.name);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.0f", hook.callsPerSecond);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", hook.avgLatencyUs);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", hook.maxLatencyUs);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", hook.frameTimeUs);
+                }
+                ImGui::EndTable();
+            }
+        }
+    }
+    ImGui::End();
 }
 
-void RND_Renderer::ImGuiOverlay::Draw3DLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, float aspectRatio, long frameIdx, VkImageLayout srcLayout) {
+void RND_Renderer::ImGuiOverlay::Draw3DLayerAsBackground(CopyBatch& copyBatch, VkImage srcImage, float aspectRatio, long frameIdx, VkImageLayout srcLayout) {
     // Log::print("Drawing 3D layer as background with aspect ratio {}, and isRendering3D {}", aspectRatio, VRManager::instance().XR->GetRenderer()->IsRendering3D());
     auto* renderer = VRManager::instance().XR->GetRenderer();
     auto& frame = renderer->GetFrame(frameIdx);
 
-    frame.mainFramebuffer->vkPipelineBarrier(cb);
-    frame.mainFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
     // AMD GPU FIX: Pass the actual source layout for proper transitions
-    frame.mainFramebuffer->vkCopyFromImage(cb, srcImage, srcLayout);
-
-    frame.mainFramebuffer->vkPipelineBarrier(cb);
-    frame.mainFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
+    frame.mainFramebuffer->vkCopyFromImage(copyBatch, srcImage, srcLayout, VK_IMAGE_LAYOUT_GENERAL);
 
     frame.mainFramebufferAspectRatio = aspectRatio;
 }
 
-void RND_Renderer::ImGuiOverlay::DrawHUDLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, long frameIdx, VkImageLayout srcLayout) {
+void RND_Renderer::ImGuiOverlay::DrawHUDLayerAsBackground(CopyBatch& copyBatch, VkImage srcImage, long frameIdx, VkImageLayout srcLayout) {
     auto* renderer = VRManager::instance().XR->GetRenderer();
     auto& frame = renderer->GetFrame(frameIdx);
 
-    frame.hudFramebuffer->vkPipelineBarrier(cb);
-    frame.hudFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    // AMD GPU FIX: Pass the actual source layout for proper transitions
-    frame.hudFramebuffer->vkCopyFromImage(cb, srcImage, srcLayout);
-    frame.hudFramebuffer->vkPipelineBarrier(cb);
-    frame.hudFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-    frame.hudWithoutAlphaFramebuffer->vkPipelineBarrier(cb);
-    frame.hudWithoutAlphaFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
     // AMD GPU FIX: Pass the actual source layout for proper transitions
-    frame.hudWithoutAlphaFramebuffer->vkCopyFromImage(cb, srcImage, srcLayout);
-    frame.hudWithoutAlphaFramebuffer->vkPipelineBarrier(cb);
-    frame.hudWithoutAlphaFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    frame.hudFramebuffer->vkCopyFromImage(copyBatch, srcImage, srcLayout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    frame.hudWithoutAlphaFramebuffer->vkCopyFromImage(copyBatch, srcImage, srcLayout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
 void RND_Renderer::ImGuiOverlay::Render() {
@@ -434,6 +560,13 @@ void RND_Renderer::ImGuiOverlay::Update() {
     if (VRManager::instance().Hooks->m_entityDebugger && isWindowFocused) {
         VRManager::instance().Hooks->m_entityDebugger->UpdateKeyboardControls();
     }
+
+    // toggle the performance HUD using F10
+    bool performanceHUDKeyDown = isWindowFocused && (GetAsyncKeyState(VK_F10) & 0x8000);
+    if (performanceHUDKeyDown && !m_performanceHUDKeyWasDown) {
+        m_showPerformanceHUD = !m_showPerformanceHUD;
+    }
+    m_performanceHUDKeyWasDown = performanceHUDKeyDown;
 }
 
 void RND_Renderer::ImGuiOverlay::DrawAndCopyToImage(VkCommandBuffer cb, VkImage destImage, long frameIdx) {
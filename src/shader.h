@@ -19,11 +19,78 @@ cbuffer g_settings : register(b1) {
     float renderHeight;
     float swapchainWidth;
     float swapchainHeight;
+    uint filter;
 };
 
 Texture2D g_colorTexture : register(t0);
 Texture2D<float> g_depthTexture : register(t1);
-SamplerState g_sampler : register(s0);
+SamplerState g_pointSampler : register(s0);
+SamplerState g_linearSampler : register(s1);
+
+// must match RND_D3D12::PresentFilter
+static const uint FILTER_POINT = 0;
+static const uint FILTER_BILINEAR = 1;
+static const uint FILTER_BOX = 2;
+static const uint FILTER_BICUBIC = 3;
+// must match PresentKernels::MAX_BOX_TAPS
+static const uint MAX_BOX_TAPS = 4;
+
+// Catmull-Rom upsampling using 9 bilinear taps instead of 16 point taps
+float4 SampleBicubic(float2 uv) {
+    float2 textureSize = float2(renderWidth, renderHeight);
+    float2 samplePos = uv * textureSize;
+    float2 texPos1 = floor(samplePos - 0.5f) + 0.5f;
+    float2 f = samplePos - texPos1;
+
+    float2 w0 = f * (-0.5f + f * (1.0f - 0.5f * f));
+    float2 w1 = 1.0f + f * f * (-2.5f + 1.5f * f);
+    float2 w2 = f * (0.5f + f * (2.0f - 1.5f * f));
+    float2 w3 = f * f * (-0.5f + 0.5f * f);
+
+    float2 w12 = w1 + w2;
+    float2 offset12 = w2 / w12;
+
+    float2 texPos0 = (texPos1 - 1.0f) / textureSize;
+    float2 texPos3 = (texPos1 + 2.0f) / textureSize;
+    float2 texPos12 = (texPos1 + offset12) / textureSize;
+
+    float4 result = 0.0f;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos0.x, texPos0.y), 0) * w0.x * w0.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos12.x, texPos0.y), 0) * w12.x * w0.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos3.x, texPos0.y), 0) * w3.x * w0.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos0.x, texPos12.y), 0) * w0.x * w12.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos12.x, texPos12.y), 0) * w12.x * w12.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos3.x, texPos12.y), 0) * w3.x * w12.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos0.x, texPos3.y), 0) * w0.x * w3.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos12.x, texPos3.y), 0) * w12.x * w3.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos3.x, texPos3.y), 0) * w3.x * w3.y;
+    // the negative lobes can overshoot
+    return max(result, 0.0f);
+}
+
+// Averages the footprint of a destination pixel. Each bilinear tap averages up to 2x2 texels, so the taps per axis grow with the ratio
+// (an exact box at 2:1, 4:1 and 8:1).
+float4 SampleBox(float2 uv) {
+    float2 footprint = 1.0f / float2(swapchainWidth, swapchainHeight);
+    uint2 taps = clamp((uint2)ceil(float2(renderWidth / swapchainWidth, renderHeight / swapchainHeight) * 0.5f), 1, MAX_BOX_TAPS);
+    float4 result = 0.0f;
+    [loop] for (uint y = 0; y < taps.y; y++) {
+        [loop] for (uint x = 0; x < taps.x; x++) {
+            float2 offset = ((float2(x, y) + 0.5f) / float2(taps) - 0.5f) * footprint;
+            result += g_colorTexture.SampleLevel(g_linearSampler, uv + offset, 0);
+        }
+    }
+    return result / (float)(taps.x * taps.y);
+}
+
+float4 SampleColor(float2 uv) {
+    [branch] switch (filter) {
+        case FILTER_BILINEAR: return g_colorTexture.SampleLevel(g_linearSampler, uv, 0);
+        case FILTER_BOX: return SampleBox(uv);
+        case FILTER_BICUBIC: return SampleBicubic(uv);
+        default: return g_colorTexture.SampleLevel(g_pointSampler, uv, 0);
+    }
+}
 
 PSInput VSMain(VSInput input) {
 	PSInput output;
@@ -39,8 +106,9 @@ PSOutput PSMain(PSInput input) {
 	float4 renderColor = float4(0.0, 1.0, 1.0, 1.0);
 	float2 samplePosition = input.uv;
 
-    float4 colorTexture = g_colorTexture.Sample(g_sampler, samplePosition);
-    float depthTexture = g_depthTexture.Sample(g_sampler, samplePosition);
+    float4 colorTexture = SampleColor(samplePosition);
+    // depth can't be interpolated between texels without creating geometry that isn't there
+    float depthTexture = g_depthTexture.Sample(g_pointSampler, samplePosition);
 
     PSOutput output;
     output.Color = float4(colorTexture.x, colorTexture.y, colorTexture.z, colorTexture.w);
@@ -69,10 +137,77 @@ cbuffer g_settings : register(b1) {
     float renderHeight;
     float swapchainWidth;
     float swapchainHeight;
+    uint filter;
 };
 
 Texture2D g_colorTexture : register(t0);
-SamplerState g_sampler : register(s0);
+SamplerState g_pointSampler : register(s0);
+SamplerState g_linearSampler : register(s1);
+
+// must match RND_D3D12::PresentFilter
+static const uint FILTER_POINT = 0;
+static const uint FILTER_BILINEAR = 1;
+static const uint FILTER_BOX = 2;
+static const uint FILTER_BICUBIC = 3;
+// must match PresentKernels::MAX_BOX_TAPS
+static const uint MAX_BOX_TAPS = 4;
+
+// Catmull-Rom upsampling using 9 bilinear taps instead of 16 point taps
+float4 SampleBicubic(float2 uv) {
+    float2 textureSize = float2(renderWidth, renderHeight);
+    float2 samplePos = uv * textureSize;
+    float2 texPos1 = floor(samplePos - 0.5f) + 0.5f;
+    float2 f = samplePos - texPos1;
+
+    float2 w0 = f * (-0.5f + f * (1.0f - 0.5f * f));
+    float2 w1 = 1.0f + f * f * (-2.5f + 1.5f * f);
+    float2 w2 = f * (0.5f + f * (2.0f - 1.5f * f));
+    float2 w3 = f * f * (-0.5f + 0.5f * f);
+
+    float2 w12 = w1 + w2;
+    float2 offset12 = w2 / w12;
+
+    float2 texPos0 = (texPos1 - 1.0f) / textureSize;
+    float2 texPos3 = (texPos1 + 2.0f) / textureSize;
+    float2 texPos12 = (texPos1 + offset12) / textureSize;
+
+    float4 result = 0.0f;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos0.x, texPos0.y), 0) * w0.x * w0.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos12.x, texPos0.y), 0) * w12.x * w0.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos3.x, texPos0.y), 0) * w3.x * w0.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos0.x, texPos12.y), 0) * w0.x * w12.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos12.x, texPos12.y), 0) * w12.x * w12.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos3.x, texPos12.y), 0) * w3.x * w12.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos0.x, texPos3.y), 0) * w0.x * w3.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos12.x, texPos3.y), 0) * w12.x * w3.y;
+    result += g_colorTexture.SampleLevel(g_linearSampler, float2(texPos3.x, texPos3.y), 0) * w3.x * w3.y;
+    // the negative lobes can overshoot
+    return max(result, 0.0f);
+}
+
+// Averages the footprint of a destination pixel. Each bilinear tap averages up to 2x2 texels, so the taps per axis grow with the ratio
+// (an exact box at 2:1, 4:1 and 8:1).
+float4 SampleBox(float2 uv) {
+    float2 footprint = 1.0f / float2(swapchainWidth, swapchainHeight);
+    uint2 taps = clamp((uint2)ceil(float2(renderWidth / swapchainWidth, renderHeight / swapchainHeight) * 0.5f), 1, MAX_BOX_TAPS);
+    float4 result = 0.0f;
+    [loop] for (uint y = 0; y < taps.y; y++) {
+        [loop] for (uint x = 0; x < taps.x; x++) {
+            float2 offset = ((float2(x, y) + 0.5f) / float2(taps) - 0.5f) * footprint;
+            result += g_colorTexture.SampleLevel(g_linearSampler, uv + offset, 0);
+        }
+    }
+    return result / (float)(taps.x * taps.y);
+}
+
+float4 SampleColor(float2 uv) {
+    [branch] switch (filter) {
+        case FILTER_BILINEAR: return g_colorTexture.SampleLevel(g_linearSampler, uv, 0);
+        case FILTER_BOX: return SampleBox(uv);
+        case FILTER_BICUBIC: return SampleBicubic(uv);
+        default: return g_colorTexture.SampleLevel(g_pointSampler, uv, 0);
+    }
+}
 
 PSInput VSMain(VSInput input) {
 	PSInput output;
@@ -88,7 +223,7 @@ PSOutput PSMain(PSInput input) {
 	float4 renderColor = float4(0.0, 1.0, 1.0, 1.0);
 	float2 samplePosition = input.uv;
 
-    float4 colorTexture = g_colorTexture.Sample(g_sampler, samplePosition);
+    float4 colorTexture = SampleColor(samplePosition);
 
     PSOutput output;
 	//output.Color = float4(0.0f, 0.0f, 0.0f, 0.0f);
@@ -98,11 +233,13 @@ PSOutput PSMain(PSInput input) {
 )hlsl";
 
 
+// passed as root constants, so keep this a multiple of 4 bytes
 struct presentSettings {
-    float renderWidth;
+    float renderWidth;     // size of the source texture
     float renderHeight;
-    float swapchainWidth;
+    float swapchainWidth;  // size of the region that's rendered to
     float swapchainHeight;
+    uint32_t filter;
     //    float eyeSeparation;
     //    float showWholeScreen;  // this mode could be used to show each display a part of the screen
     //    float showSingleScreen; // this mode shows the same picture in each eye
@@ -0,0 +1,187 @@
+#pragma once
+#include "pch.h"
+
+#include <span>
+#include <vector>
+
+// Collects image layout transitions so that they can be recorded as a single vkCmdPipelineBarrier2.
+// The stage and access masks of each barrier are derived from the old and new layout, instead of synchronizing against all commands.
+class BarrierBatch {
+public:
+    struct LayoutUsage {
+        VkPipelineStageFlags2 stages;
+        VkAccessFlags2 access;
+    };
+
+    // the stages and accesses that can use an image while it's in the given layout
+    static constexpr LayoutUsage GetLayoutUsage(VkImageLayout layout) {
+        switch (layout) {
+            case VK_IMAGE_LAYOUT_UNDEFINED:
+            case VK_IMAGE_LAYOUT_PREINITIALIZED:
+                return { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+                return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT };
+            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+                return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+                return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
+                return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+                return { VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT };
+            case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+                // presentation is synchronized through semaphores
+                return { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+            default:
+                // GENERAL (which both Cemu and the D3D12 interop use) doesn't say anything about how the image is used
+                return { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT };
+        }
+    }
+
+    // Adds a transition for the whole image. Transitioning an image that's already in the batch merges both into one barrier.
+    void Transition(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout oldLayout, VkImageLayout newLayout) {
+        for (VkImageMemoryBarrier2& barrier : m_barriers) {
+            if (barrier.image != image)
+                continue;
+
+            // e.g. multiple copies from the same source image
+            if (barrier.oldLayout == oldLayout && barrier.newLayout == newLayout) {
+                barrier.subresourceRange.aspectMask |= aspectMask;
+                return;
+            }
+            if (barrier.newLayout != oldLayout) {
+                Log::print<WARNING>("BarrierBatch: image {} is transitioned from {} but was previously transitioned to {}", (void*)image, (int)oldLayout, (int)barrier.newLayout);
+            }
+            const LayoutUsage dstUsage = GetLayoutUsage(newLayout);
+            barrier.newLayout = newLayout;
+            barrier.dstStageMask = dstUsage.stages;
+            barrier.dstAccessMask = dstUsage.access;
+            barrier.subresourceRange.aspectMask |= aspectMask;
+            return;
+        }
+
+        // AMD GPU FIX: Skip redundant transitions - some AMD drivers are strict about this
+        if (oldLayout == newLayout)
+            return;
+
+        const LayoutUsage srcUsage = GetLayoutUsage(oldLayout);
+        const LayoutUsage dstUsage = GetLayoutUsage(newLayout);
+
+        VkImageMemoryBarrier2 barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+        barrier.srcStageMask = srcUsage.stages;
+        // only writes need to be made available, earlier reads just need the execution dependency
+        barrier.srcAccessMask = srcUsage.access & WRITE_ACCESS_MASK;
+        barrier.dstStageMask = dstUsage.stages;
+        barrier.dstAccessMask = dstUsage.access;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        // AMD GPU FIX: Use VK_REMAINING to cover all subresources
+        barrier.subresourceRange = {
+            .aspectMask = aspectMask,
+            .baseMipLevel = 0,
+            .levelCount = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS
+        };
+        m_barriers.emplace_back(barrier);
+    }
+
+    bool Empty() const { return m_barriers.empty(); }
+    std::span<const VkImageMemoryBarrier2> GetBarriers() const { return m_barriers; }
+
+    // records all collected transitions as one barrier and clears the batch
+    void Flush(VkCommandBuffer cmdBuffer) {
+        if (m_barriers.empty())
+            return;
+
+        VkDependencyInfo dependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+        dependencyInfo.imageMemoryBarrierCount = (uint32_t)m_barriers.size();
+        dependencyInfo.pImageMemoryBarriers = m_barriers.data();
+        vkroots::tables::LookupDeviceDispatch(cmdBuffer)->CmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+        m_barriers.clear();
+    }
+
+private:
+    static constexpr VkAccessFlags2 WRITE_ACCESS_MASK = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+    std::vector<VkImageMemoryBarrier2> m_barriers;
+};
+
+// Records multiple image copies that share the same barriers: one batch of transitions before all copies, and one after.
+class CopyBatch {
+public:
+    struct Copy {
+        VkImage srcImage;
+        VkImage dstImage;
+        VkImageCopy region;
+        VkQueryPool timestampPool; // optional, writes a timestamp to query 0 and 1 around the copy
+    };
+
+    // copies (parts of) an image into a host-visible buffer, after which a marker is written so that the CPU can tell when the data has landed
+    struct Readback {
+        VkImage srcImage;
+        VkBuffer dstBuffer;
+        std::vector<VkBufferImageCopy> regions;
+        VkDeviceSize markerOffset;
+        uint32_t marker;
+    };
+
+    BarrierBatch& PreCopy() { return m_preCopy; }
+    BarrierBatch& PostCopy() { return m_postCopy; }
+
+    void AddCopy(const Copy& copy) { m_copies.emplace_back(copy); }
+    void AddReadback(Readback readback) { m_readbacks.emplace_back(std::move(readback)); }
+
+    void Record(VkCommandBuffer cmdBuffer) {
+        const auto* dispatch = vkroots::tables::LookupDeviceDispatch(cmdBuffer);
+
+        m_preCopy.Flush(cmdBuffer);
+        for (const Copy& copy : m_copies) {
+            if (copy.timestampPool != VK_NULL_HANDLE) {
+                dispatch->CmdResetQueryPool(cmdBuffer, copy.timestampPool, 0, 2);
+                dispatch->CmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, copy.timestampPool, 0);
+            }
+            dispatch->CmdCopyImage(cmdBuffer, copy.srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, copy.dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+            if (copy.timestampPool != VK_NULL_HANDLE) {
+                dispatch->CmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, copy.timestampPool, 1);
+            }
+        }
+        if (!m_readbacks.empty()) {
+            for (const Readback& readback : m_readbacks) {
+                dispatch->CmdCopyImageToBuffer(cmdBuffer, readback.srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.dstBuffer, (uint32_t)readback.regions.size(), readback.regions.data());
+            }
+            // the markers may only be written once the data is, and both have to be visible to the host
+            RecordMemoryBarrier(cmdBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            for (const Readback& readback : m_readbacks) {
+                dispatch->CmdUpdateBuffer(cmdBuffer, readback.dstBuffer, readback.markerOffset, sizeof(readback.marker), &readback.marker);
+            }
+            RecordMemoryBarrier(cmdBuffer, VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT);
+        }
+        m_postCopy.Flush(cmdBuffer);
+        m_copies.clear();
+        m_readbacks.clear();
+    }
+
+private:
+    static void RecordMemoryBarrier(VkCommandBuffer cmdBuffer, VkPipelineStageFlags2 dstStages, VkAccessFlags2 dstAccess) {
+        VkMemoryBarrier2 barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.dstStageMask = dstStages;
+        barrier.dstAccessMask = dstAccess;
+
+        VkDependencyInfo dependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+        dependencyInfo.memoryBarrierCount = 1;
+        dependencyInfo.pMemoryBarriers = &barrier;
+        vkroots::tables::LookupDeviceDispatch(cmdBuffer)->CmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+    }
+
+    BarrierBatch m_preCopy;
+    BarrierBatch m_postCopy;
+    std::vector<Copy> m_copies;
+    std::vector<Readback> m_readbacks;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include "pch.h"
+
+#include <optional>
+#include <span>
+#include <vector>
+
+// Scheduling for the eye copies on a separate queue: which queue they're submitted to, and how that queue and Cemu's queue wait on each other.
+namespace CopySchedule {
+    struct QueueSelection {
+        uint32_t familyIndex;
+        uint32_t queueIndex;
+        bool addsQueueCreateInfo; // whether Cemu doesn't use the family yet, otherwise the queue count of its create info is increased by one
+    };
+
+    // Picks a queue family without graphics support that still has a queue left after the queues Cemu requested.
+    // Async compute families are preferred over transfer-only families, and the family has to support timestamps since the copies are timed.
+    // Returns nothing if there's no such family, in which case the copies stay in Cemu's command buffers.
+    inline std::optional<QueueSelection> SelectQueue(std::span<const VkQueueFamilyProperties> families, std::span<const VkDeviceQueueCreateInfo> requestedQueues) {
+        std::optional<QueueSelection> selection;
+        int selectionScore = 0;
+        for (uint32_t family = 0; family < (uint32_t)families.size(); ++family) {
+            const VkQueueFlags flags = families[family].queueFlags;
+            if ((flags & VK_QUEUE_GRAPHICS_BIT) != 0 || families[family].timestampValidBits == 0)
+                continue;
+
+            // compute queues always support transfers, even if they don't report it
+            const int score = (flags & VK_QUEUE_COMPUTE_BIT) != 0 ? 2 : (flags & VK_QUEUE_TRANSFER_BIT) != 0 ? 1 : 0;
+            if (score <= selectionScore)
+                continue;
+
+            const auto requested = std::ranges::find(requestedQueues, family, &VkDeviceQueueCreateInfo::queueFamilyIndex);
+            const uint32_t requestedCount = requested != requestedQueues.end() ? requested->queueCount : 0;
+            if (requestedCount >= families[family].queueCount)
+                continue;
+
+            selection = QueueSelection{ family, requestedCount, requested == requestedQueues.end() };
+            selectionScore = score;
+        }
+        return selection;
+    }
+
+    // Plans the values of the two timeline semaphores that order the copy queue with Cemu's queue.
+    // Cemu's submit copies into the staging images and signals the staged timeline, the copy queue waits for it and signals the copied timeline.
+    // Before a staging image gets overwritten by a later submit, that submit has to wait until the previous copy from it has finished.
+    // Every timeline is only signalled from one queue, so that its values are always signalled in increasing order.
+    class TimelinePlanner {
+    public:
+        struct SubmitPlan {
+            uint64_t waitCopied; // 0 if none of the staging images were used before
+            uint64_t signalStaged;
+            uint64_t signalCopied;
+        };
+
+        // plans are numbered in the order they're made, so they have to be submitted in that order as well
+        SubmitPlan PlanSubmit(std::span<const uint32_t> stagingSlots) {
+            SubmitPlan plan = { 0, ++m_stagedValue, ++m_copiedValue };
+            for (uint32_t slot : stagingSlots) {
+                if (slot >= m_lastCopied.size())
+                    m_lastCopied.resize(slot + 1, 0);
+                plan.waitCopied = std::max(plan.waitCopied, m_lastCopied[slot]);
+                m_lastCopied[slot] = plan.signalCopied;
+            }
+            return plan;
+        }
+
+        uint64_t GetLastCopiedValue(uint32_t slot) const { return slot < m_lastCopied.size() ? m_lastCopied[slot] : 0; }
+
+    private:
+        uint64_t m_stagedValue = 0;
+        uint64_t m_copiedValue = 0;
+        std::vector<uint64_t> m_lastCopied;
+    };
+}
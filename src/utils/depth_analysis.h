@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define DEPTH_ANALYSIS_SSE 1
+#else
+#define DEPTH_ANALYSIS_SSE 0
+#endif
+
+// Helpers to measure the range of depths in a depth buffer that was read back to the CPU.
+// Depth values are expected to map 0 to the near plane and 1 to the far plane.
+namespace DepthAnalysis {
+    struct Range {
+        float minDepth;
+        float maxDepth;
+    };
+
+    // single pass over count depth values, an empty buffer returns the full range
+    inline Range Reduce(const float* depth, size_t count) {
+        if (count == 0)
+            return { 0.0f, 1.0f };
+
+        float minDepth = depth[0];
+        float maxDepth = depth[0];
+        size_t i = 0;
+#if DEPTH_ANALYSIS_SSE
+        if (count >= 4) {
+            __m128 minValues = _mm_loadu_ps(depth);
+            __m128 maxValues = minValues;
+            for (i = 4; i + 4 <= count; i += 4) {
+                const __m128 values = _mm_loadu_ps(depth + i);
+                minValues = _mm_min_ps(minValues, values);
+                maxValues = _mm_max_ps(maxValues, values);
+            }
+            alignas(16) float mins[4], maxs[4];
+            _mm_store_ps(mins, minValues);
+            _mm_store_ps(maxs, maxValues);
+            minDepth = std::min({ mins[0], mins[1], mins[2], mins[3] });
+            maxDepth = std::max({ maxs[0], maxs[1], maxs[2], maxs[3] });
+        }
+#endif
+        for (; i < count; ++i) {
+            minDepth = std::min(minDepth, depth[i]);
+            maxDepth = std::max(maxDepth, depth[i]);
+        }
+        return { minDepth, maxDepth };
+    }
+
+    // distance in front of the camera of a depth value
+    inline float LinearizeDepth(float depth, float nearZ, float farZ) {
+        return (nearZ * farZ) / (farZ - depth * (farZ - nearZ));
+    }
+
+    // inverse of LinearizeDepth()
+    inline float DistanceToDepth(float distance, float nearZ, float farZ) {
+        return (farZ - (nearZ * farZ) / distance) / (farZ - nearZ);
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Critically damped spring, which moves towards its target as fast as possible without overshooting.
+// It's time based, so it behaves the same at any frame rate.
+template <typename T>
+struct CriticallyDampedSpring {
+    T value = T(0.0f);
+    T velocity = T(0.0f);
+
+    void Reset(const T& newValue) {
+        value = newValue;
+        velocity = T(0.0f);
+    }
+
+    // smoothTime is roughly the time it takes to reach the target
+    const T& Update(const T& target, float smoothTime, float deltaSeconds) {
+        const float omega = 2.0f / std::max(smoothTime, 1e-4f);
+        const float x = omega * deltaSeconds;
+        const float decay = 1.0f / (1.0f + x + 0.48f * x * x + 0.235f * x * x * x);
+        const T change = value - target;
+        const T temp = (velocity + omega * change) * deltaSeconds;
+        velocity = (velocity - omega * temp) * decay;
+        value = target + (change + temp) * decay;
+        return value;
+    }
+};
+
+// Places a quad in front of the head that follows where the user is looking.
+// Small head movements inside the dead zone leave the quad where it is, larger ones make it follow with a spring.
+// The head's angular velocity is used to lead the target, which makes up for most of the delay that the spring adds while turning.
+class FollowFilter {
+public:
+    struct Settings {
+        float distance = 2.0f; // in meters in front of the head
+        float smoothTime = 0.1f; // in seconds
+        float deadZoneRadians = 0.09f; // ~5 degrees, the quad starts following once the view is this far off
+        float settleRadians = 0.01f; // the quad stops following once it's this close again
+        float predictionSeconds = 0.05f; // how far ahead the head's rotation is extrapolated
+        float maxDeltaSeconds = 0.1f; // longer gaps (e.g. a loading screen) are treated as this long
+        float maxPitchRadians = 1.4f; // ~80 degrees, the quad stops rising or sinking past this so that it never ends up straight above or below the head
+    };
+
+    struct Pose {
+        glm::fvec3 position;
+        glm::fquat orientation;
+    };
+
+    FollowFilter() = default;
+    explicit FollowFilter(const Settings& settings): m_settings(settings) {}
+
+    void Reset() { m_initialized = false; }
+
+    // head pose at the display time in stage space, its angular velocity in radians per second in stage space, and the time since the last update
+    Pose Update(const glm::fvec3& headPosition, const glm::fquat& headOrientation, const glm::fvec3& headAngularVelocity, float deltaSeconds) {
+        const float dt = std::clamp(deltaSeconds, 0.0f, m_settings.maxDeltaSeconds);
+
+        // lead the target by the head's rotation over the prediction time
+        glm::fquat predictedOrientation = headOrientation;
+        const float angularSpeed = glm::length(headAngularVelocity);
+        if (angularSpeed > 1e-4f) {
+            predictedOrientation = glm::normalize(glm::angleAxis(angularSpeed * m_settings.predictionSeconds, headAngularVelocity / angularSpeed) * headOrientation);
+        }
+        const glm::fvec3 targetForward = predictedOrientation * glm::fvec3(0.0f, 0.0f, -1.0f);
+
+        if (!m_initialized) {
+            m_initialized = true;
+            m_following = false;
+            m_forward.Reset(targetForward);
+            m_anchor.Reset(headPosition);
+        }
+
+        // the spring can pass through zero when the target flips around, there's no direction left to normalize then
+        if (glm::length(m_forward.value) < 1e-4f) {
+            m_forward.Reset(targetForward);
+        }
+
+        // hysteresis, so that the quad doesn't keep making tiny corrections
+        const float offAngle = AngleBetween(glm::normalize(m_forward.value), targetForward);
+        if (!m_following && offAngle > m_settings.deadZoneRadians) {
+            m_following = true;
+        }
+        else if (m_following && offAngle < m_settings.settleRadians && glm::length(m_forward.velocity) < m_settings.settleRadians) {
+            m_following = false;
+        }
+
+        if (m_following) {
+            m_forward.Update(targetForward, m_settings.smoothTime, dt);
+        }
+        else {
+            m_forward.velocity = glm::fvec3(0.0f);
+        }
+        m_anchor.Update(headPosition, m_settings.smoothTime, dt);
+
+        // The orientation is built with world up, which has no heading to go on when looking straight up or down.
+        // The heading of the last update is kept then, and the pitch is clamped so that the quad stays upright.
+        const glm::fvec3 worldUp = glm::fvec3(0.0f, 1.0f, 0.0f);
+        const glm::fvec3 springForward = glm::normalize(m_forward.value);
+        const float horizontalLength = glm::length(glm::fvec2(springForward.x, springForward.z));
+        if (horizontalLength > 1e-4f) {
+            m_right = glm::normalize(glm::cross(glm::fvec3(springForward.x, 0.0f, springForward.z), worldUp));
+        }
+        const glm::fvec3 heading = glm::cross(worldUp, m_right);
+        const float pitch = std::clamp(std::atan2(springForward.y, horizontalLength), -m_settings.maxPitchRadians, m_settings.maxPitchRadians);
+        const glm::fvec3 forward = std::cos(pitch) * heading + std::sin(pitch) * worldUp;
+        const glm::fvec3 up = glm::cross(m_right, forward);
+        return { m_anchor.value + m_settings.distance * forward, glm::quatLookAt(forward, up) };
+    }
+
+    bool IsFollowing() const { return m_following; }
+    const Settings& GetSettings() const { return m_settings; }
+
+private:
+    static float AngleBetween(const glm::fvec3& a, const glm::fvec3& b) {
+        return std::acos(std::clamp(glm::dot(a, b), -1.0f, 1.0f));
+    }
+
+    Settings m_settings;
+    bool m_initialized = false;
+    bool m_following = false;
+    CriticallyDampedSpring<glm::fvec3> m_forward;
+    CriticallyDampedSpring<glm::fvec3> m_anchor;
+    glm::fvec3 m_right = glm::fvec3(1.0f, 0.0f, 0.0f);
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Detects which of the runtime's foveation and quad view extensions are available, only to report them in the log.
+// None of them apply to the 3D layer, which is an upscaled copy of the game's (single) view per eye that's drawn with D3D12:
+// - quad views need the game to render a separate, narrower view for the focus area of each eye
+// - swapchain foveation (XR_FB_foveation) is only defined for swapchains that are rendered to with OpenGL ES or Vulkan
+namespace FoveationSupport {
+    struct Support {
+        bool fbFoveation = false;
+        bool fbFoveationConfiguration = false;
+        bool fbSwapchainUpdateState = false;
+        bool metaEyeTrackedFoveation = false;
+        bool varjoQuadViews = false;
+    };
+
+    inline Support Detect(const std::vector<std::string>& availableExtensions) {
+        auto has = [&](std::string_view name) { return std::ranges::find(availableExtensions, name) != availableExtensions.end(); };
+        Support support;
+        support.fbFoveation = has("XR_FB_foveation");
+        support.fbFoveationConfiguration = has("XR_FB_foveation_configuration");
+        support.fbSwapchainUpdateState = has("XR_FB_swapchain_update_state");
+        support.metaEyeTrackedFoveation = has("XR_META_foveation_eye_tracked");
+        support.varjoQuadViews = has("XR_VARJO_quad_views");
+        return support;
+    }
+
+    // why the eyes are still rendered as plain stereo
+    inline const char* Describe(const Support& support) {
+        if (support.varjoQuadViews)
+            return "quad views are available, but the game only renders a single view per eye";
+        if (support.fbFoveation && support.fbFoveationConfiguration && support.fbSwapchainUpdateState)
+            return support.metaEyeTrackedFoveation ? "eye tracked swapchain foveation is available, but not for D3D12 swapchains" : "swapchain foveation is available, but not for D3D12 swapchains";
+        return "the runtime doesn't support foveation or quad views";
+    }
+}
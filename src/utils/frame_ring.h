@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+// Tracks the frames that are in flight between the game capturing them and the renderer submitting them to the runtime.
+// Every slot goes through FREE -> CAPTURING -> CAPTURED -> SUBMITTING -> RETIRED, after which it's captured into again.
+// A slot's state, the captures that were made for its frame and whether it was presented are kept in a single atomic word,
+// so that the capturing thread (Cemu's Vulkan thread) and the submitting thread (the PPC thread) never see half of an update.
+template <size_t N>
+class FrameRing {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class State : uint32_t {
+        FREE,
+        CAPTURING,
+        CAPTURED,
+        SUBMITTING,
+        RETIRED,
+        COUNT
+    };
+
+    enum Capture : uint32_t {
+        COLOR_LEFT = 1 << 0,
+        COLOR_RIGHT = 1 << 1,
+        DEPTH_LEFT = 1 << 2,
+        DEPTH_RIGHT = 1 << 3,
+        HUD = 1 << 4,
+    };
+    static constexpr uint32_t CAPTURES_3D = COLOR_LEFT | COLOR_RIGHT | DEPTH_LEFT | DEPTH_RIGHT;
+    static constexpr uint32_t CAPTURES_ALL = CAPTURES_3D | HUD;
+
+    static constexpr size_t SIZE = N;
+
+    // Whether the capture was already made for the slot's current frame. A slot that's being submitted counts its captures as made,
+    // so that its textures aren't overwritten while they're submitted.
+    bool IsCaptured(size_t slot, Capture capture) const {
+        const uint32_t word = m_slots[slot].word.load(std::memory_order_acquire);
+        const State state = UnpackState(word);
+        return (state == State::CAPTURING || state == State::CAPTURED || state == State::SUBMITTING) && (UnpackCaptures(word) & capture) != 0;
+    }
+
+    bool HasCaptures(size_t slot, uint32_t captures) const {
+        return (UnpackCaptures(m_slots[slot].word.load(std::memory_order_acquire)) & captures) == captures;
+    }
+
+    // starts a new frame in the slot if it was free or retired, the slot becomes CAPTURED once all captures were made
+    void MarkCaptured(size_t slot, Capture capture) {
+        Slot& entry = m_slots[slot];
+        uint32_t word = entry.word.load(std::memory_order_acquire);
+        while (true) {
+            const State state = UnpackState(word);
+            if (state == State::SUBMITTING)
+                return;
+
+            const bool startsFrame = state == State::FREE || state == State::RETIRED;
+            const uint32_t captures = (startsFrame ? 0 : UnpackCaptures(word)) | capture;
+            const State newState = (captures & CAPTURES_ALL) == CAPTURES_ALL ? State::CAPTURED : State::CAPTURING;
+            if (entry.word.compare_exchange_weak(word, Pack(newState, captures, (word & PRESENTED_3D_BIT) != 0), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                const Clock::time_point now = Clock::now();
+                if (startsFrame)
+                    Stamp(entry, State::CAPTURING, now);
+                if (newState != state)
+                    Stamp(entry, newState, now);
+                return;
+            }
+        }
+    }
+
+    // Picks the slot to submit and moves it to SUBMITTING. Slots with all captures are preferred over slots that only have their HUD captured,
+    // and the oldest frame is picked if there's more than one.
+    std::optional<size_t> BeginSubmit() {
+        for (uint32_t requiredCaptures : { CAPTURES_ALL, (uint32_t)HUD }) {
+            while (true) {
+                std::optional<size_t> oldest;
+                uint32_t oldestWord = 0;
+                for (size_t i = 0; i < N; ++i) {
+                    const uint32_t word = m_slots[i].word.load(std::memory_order_acquire);
+                    const State state = UnpackState(word);
+                    if (state != State::CAPTURING && state != State::CAPTURED)
+                        continue;
+                    if ((UnpackCaptures(word) & requiredCaptures) != requiredCaptures)
+                        continue;
+                    if (!oldest || GetTransitionTime(i, State::CAPTURING) < GetTransitionTime(*oldest, State::CAPTURING)) {
+                        oldest = i;
+                        oldestWord = word;
+                    }
+                }
+                if (!oldest)
+                    break;
+
+                // a capture that lands in between is kept, the slot is just looked at again
+                if (m_slots[*oldest].word.compare_exchange_strong(oldestWord, Pack(State::SUBMITTING, UnpackCaptures(oldestWord), (oldestWord & PRESENTED_3D_BIT) != 0), std::memory_order_acq_rel)) {
+                    Stamp(m_slots[*oldest], State::SUBMITTING, Clock::now());
+                    return oldest;
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    // retires the slot, which can then be captured into again
+    void FinishSubmit(size_t slot, bool presented3D) {
+        m_slots[slot].word.store(Pack(State::RETIRED, 0, presented3D), std::memory_order_release);
+        Stamp(m_slots[slot], State::RETIRED, Clock::now());
+    }
+
+    // whether the 3D layer was submitted the last time the slot was retired
+    bool WasPresented3D(size_t slot) const {
+        return (m_slots[slot].word.load(std::memory_order_acquire) & PRESENTED_3D_BIT) != 0;
+    }
+
+    State GetState(size_t slot) const { return UnpackState(m_slots[slot].word.load(std::memory_order_acquire)); }
+
+    Clock::time_point GetTransitionTime(size_t slot, State state) const {
+        return Clock::time_point(Clock::duration(m_slots[slot].transitionTimes[(size_t)state].load(std::memory_order_relaxed)));
+    }
+
+    // a slot that has been capturing for longer than the threshold, which means the game stopped rendering in the middle of a frame
+    std::optional<size_t> FindStalledSlot(Clock::duration threshold, Clock::time_point now = Clock::now()) const {
+        for (size_t i = 0; i < N; ++i) {
+            const State state = GetState(i);
+            if ((state == State::CAPTURING || state == State::CAPTURED) && now - GetTransitionTime(i, State::CAPTURING) > threshold)
+                return i;
+        }
+        return std::nullopt;
+    }
+
+private:
+    static constexpr uint32_t STATE_MASK = 0xFF;
+    static constexpr uint32_t CAPTURES_SHIFT = 8;
+    static constexpr uint32_t PRESENTED_3D_BIT = 1u << 16;
+
+    struct Slot {
+        std::atomic<uint32_t> word = 0;
+        std::array<std::atomic<Clock::rep>, (size_t)State::COUNT> transitionTimes = {};
+    };
+
+    static constexpr uint32_t Pack(State state, uint32_t captures, bool presented3D) {
+        return (uint32_t)state | (captures << CAPTURES_SHIFT) | (presented3D ? PRESENTED_3D_BIT : 0);
+    }
+    static constexpr State UnpackState(uint32_t word) { return (State)(word & STATE_MASK); }
+    static constexpr uint32_t UnpackCaptures(uint32_t word) { return (word >> CAPTURES_SHIFT) & CAPTURES_ALL; }
+
+    static void Stamp(Slot& slot, State state, Clock::time_point time) {
+        slot.transitionTimes[(size_t)state].store(time.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    std::array<Slot, N> m_slots;
+};
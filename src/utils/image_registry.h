@@ -0,0 +1,93 @@
+#pragma once
+#include "pch.h"
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+// Keeps track of the images Cemu creates that are large enough to be one of the eye framebuffers.
+// Lookups first check a counting filter without taking any lock, so that the (vast majority of) images that were never registered bail out immediately.
+// Registered images are spread over multiple shards that each have their own reader/writer lock, so that concurrent lookups never block each other.
+class ImageRegistry {
+public:
+    static constexpr uint32_t MIN_WIDTH = 1280;
+    static constexpr uint32_t MIN_HEIGHT = 720;
+
+    struct ImageInfo {
+        VkExtent2D extent;
+        VkFormat format;
+        VkImageUsageFlags usage;
+        bool stereoCandidate; // whether its format matches the color or depth buffer of the 3D layer
+    };
+
+    static bool IsTracked(const VkImageCreateInfo* pCreateInfo) {
+        return pCreateInfo->extent.width >= MIN_WIDTH && pCreateInfo->extent.height >= MIN_HEIGHT;
+    }
+
+    // returns false if the image was already registered
+    bool Register(VkImage image, const VkImageCreateInfo* pCreateInfo) {
+        const ImageInfo info = {
+            .extent = { pCreateInfo->extent.width, pCreateInfo->extent.height },
+            .format = pCreateInfo->format,
+            .usage = pCreateInfo->usage,
+            .stereoCandidate = pCreateInfo->format == VK_FORMAT_B10G11R11_UFLOAT_PACK32 || pCreateInfo->format == VK_FORMAT_D32_SFLOAT
+        };
+
+        Shard& shard = GetShard(image);
+        std::unique_lock lock(shard.mutex);
+        if (!shard.images.try_emplace(image, info).second)
+            return false;
+        // only increment after the image is in the map, so that a lookup that passes the filter will always find it
+        m_filter[GetFilterIdx(image)].fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    void Unregister(VkImage image) {
+        if (m_filter[GetFilterIdx(image)].load(std::memory_order_acquire) == 0)
+            return;
+
+        Shard& shard = GetShard(image);
+        std::unique_lock lock(shard.mutex);
+        if (shard.images.erase(image) != 0) {
+            m_filter[GetFilterIdx(image)].fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    std::optional<ImageInfo> Find(VkImage image) const {
+        // negative cache: no registered image hashes to this entry
+        if (m_filter[GetFilterIdx(image)].load(std::memory_order_acquire) == 0)
+            return std::nullopt;
+
+        const Shard& shard = GetShard(image);
+        std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.images.find(image); it != shard.images.end())
+            return it->second;
+        return std::nullopt;
+    }
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t FILTER_SIZE = 4096;
+
+    // handles are pointers or driver-assigned ids, so mix the bits before using them as indices
+    static uint64_t Hash(VkImage image) {
+        uint64_t hash = (uint64_t)image;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+    static size_t GetFilterIdx(VkImage image) { return Hash(image) % FILTER_SIZE; }
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<VkImage, ImageInfo> images;
+    };
+    Shard& GetShard(VkImage image) { return m_shards[(Hash(image) >> 32) % SHARD_COUNT]; }
+    const Shard& GetShard(VkImage image) const { return m_shards[(Hash(image) >> 32) % SHARD_COUNT]; }
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+    std::array<std::atomic<uint32_t>, FILTER_SIZE> m_filter = {};
+};
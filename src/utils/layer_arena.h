@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <span>
+
+// Fixed capacity storage for the composition layers that are passed to xrEndFrame, so that building a frame's layers never allocates.
+// Layers are filled in place and the header array points into the arena itself, everything stays valid until the next Reset().
+// Chained structs (e.g. the depth info of a projection view) aren't copied and have to outlive the xrEndFrame call on their own.
+class CompositionLayerArena {
+public:
+    static constexpr size_t MAX_PROJECTION_VIEWS = 2;
+    static constexpr size_t MAX_QUADS = 4;
+    static constexpr size_t MAX_LAYERS = 1 + MAX_QUADS;
+
+    void Reset() {
+        m_hasProjection = false;
+        m_quadCount = 0;
+        m_layerCount = 0;
+    }
+
+    // adds the projection layer with a copy of the views, returns false if there already is one
+    bool AddProjection(XrCompositionLayerFlags layerFlags, XrSpace space, std::span<const XrCompositionLayerProjectionView> views) {
+        if (m_hasProjection || views.size() > MAX_PROJECTION_VIEWS || m_layerCount == MAX_LAYERS)
+            return false;
+
+        std::copy(views.begin(), views.end(), m_projectionViews.begin());
+        m_projection = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
+        m_projection.layerFlags = layerFlags;
+        m_projection.space = space;
+        m_projection.viewCount = (uint32_t)views.size();
+        m_projection.views = m_projectionViews.data();
+        m_hasProjection = true;
+        m_layers[m_layerCount++] = reinterpret_cast<const XrCompositionLayerBaseHeader*>(&m_projection);
+        return true;
+    }
+
+    // returns false if the arena has no room for another quad, in which case the quad is left out of the frame
+    bool AddQuad(const XrCompositionLayerQuad& quad) {
+        if (m_quadCount == MAX_QUADS || m_layerCount == MAX_LAYERS)
+            return false;
+
+        XrCompositionLayerQuad& entry = m_quads[m_quadCount++];
+        entry = quad;
+        m_layers[m_layerCount++] = reinterpret_cast<const XrCompositionLayerBaseHeader*>(&entry);
+        return true;
+    }
+
+    // layers in the order they were added, which is the order they're composited in
+    const XrCompositionLayerBaseHeader* const* GetLayers() const { return m_layers.data(); }
+    uint32_t GetLayerCount() const { return m_layerCount; }
+    bool HasProjection() const { return m_hasProjection; }
+
+private:
+    XrCompositionLayerProjection m_projection = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
+    std::array<XrCompositionLayerProjectionView, MAX_PROJECTION_VIEWS> m_projectionViews = {};
+    bool m_hasProjection = false;
+
+    std::array<XrCompositionLayerQuad, MAX_QUADS> m_quads = {};
+    size_t m_quadCount = 0;
+
+    std::array<const XrCompositionLayerBaseHeader*, MAX_LAYERS> m_layers = {};
+    uint32_t m_layerCount = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include "pch.h"
+#include "utils/barrier_batch.h"
+
+// Tracks the layout of one of Cemu's images while a clear hook records the layer's copies from it.
+// It starts out in the layout Cemu passed to its clear, and every transition the hook makes goes through it.
+// This way transitions to the layout the image is already in (e.g. TRANSFER_DST_OPTIMAL when Cemu clears in that layout) are never recorded,
+// and the image only goes back to Cemu's layout once after the last copy instead of after every copy.
+// Since every hook restores the image before it returns, no state has to be kept across hooks or command buffers.
+class ImageLayoutTracker {
+public:
+    ImageLayoutTracker(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout cemuLayout): m_image(image), m_aspectMask(aspectMask), m_cemuLayout(cemuLayout), m_currentLayout(cemuLayout) {}
+    ~ImageLayoutTracker() {
+        if (m_currentLayout != m_cemuLayout) {
+            Log::print<WARNING>("ImageLayoutTracker: Image {} is left in layout {} while Cemu expects layout {}", (void*)m_image, (int)m_currentLayout, (int)m_cemuLayout);
+        }
+    }
+
+    ImageLayoutTracker(const ImageLayoutTracker&) = delete;
+    ImageLayoutTracker& operator=(const ImageLayoutTracker&) = delete;
+
+    // adds a transition to the batch unless the image is already in the new layout, returns whether one was added
+    bool Transition(BarrierBatch& batch, VkImageLayout newLayout) {
+        if (m_currentLayout == newLayout)
+            return false;
+        batch.Transition(m_image, m_aspectMask, m_currentLayout, newLayout);
+        m_currentLayout = newLayout;
+        return true;
+    }
+
+    // adds a transition back to the layout that Cemu expects the image to be in
+    bool Restore(BarrierBatch& batch) { return Transition(batch, m_cemuLayout); }
+
+    VkImageLayout GetLayout() const { return m_currentLayout; }
+
+private:
+    VkImage m_image;
+    VkImageAspectFlags m_aspectMask;
+    VkImageLayout m_cemuLayout;
+    VkImageLayout m_currentLayout;
+};
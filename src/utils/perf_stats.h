@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <span>
+
+// note: this file intentionally only depends on the standard library so that it can be used outside of the layer
+
+// Fixed-size sample history that overwrites the oldest sample once it's full
+template <typename T, size_t N>
+class RingBuffer {
+public:
+    void Push(const T& value) {
+        m_data[m_head] = value;
+        m_head = (m_head + 1) % N;
+        m_size = std::min(m_size + 1, N);
+    }
+
+    void Clear() {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    // index 0 is the oldest sample, Size()-1 the newest
+    const T& operator[](size_t idx) const { return m_data[(m_head + N - m_size + idx) % N]; }
+    const T& Latest() const { return (*this)[m_size - 1]; }
+
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    static constexpr size_t Capacity() { return N; }
+
+private:
+    std::array<T, N> m_data = {};
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
+
+template <size_t N>
+class SampleHistory {
+public:
+    struct Summary {
+        float min = 0.0f;
+        float max = 0.0f;
+        float avg = 0.0f;
+        float last = 0.0f;
+    };
+
+    void Push(float value) { m_samples.Push(value); }
+    void Clear() { m_samples.Clear(); }
+    size_t Size() const { return m_samples.Size(); }
+    float operator[](size_t idx) const { return m_samples[idx]; }
+
+    Summary Summarize() const {
+        Summary summary = {};
+        if (m_samples.Empty())
+            return summary;
+
+        summary.min = std::numeric_limits<float>::max();
+        summary.max = std::numeric_limits<float>::lowest();
+        double total = 0.0;
+        for (size_t i = 0; i < m_samples.Size(); ++i) {
+            summary.min = std::min(summary.min, m_samples[i]);
+            summary.max = std::max(summary.max, m_samples[i]);
+            total += m_samples[i];
+        }
+        summary.avg = (float)(total / (double)m_samples.Size());
+        summary.last = m_samples.Latest();
+        return summary;
+    }
+
+    // Reduces the history to (at most) outMin.size() buckets, keeping the min/max of each bucket so that single-frame spikes don't disappear when plotting.
+    // Returns the amount of buckets that were written.
+    size_t Downsample(std::span<float> outMin, std::span<float> outMax, std::span<float> outAvg) const {
+        const size_t sampleCount = m_samples.Size();
+        const size_t bucketCount = std::min({ sampleCount, outMin.size(), outMax.size(), outAvg.size() });
+
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+            const size_t begin = bucket * sampleCount / bucketCount;
+            const size_t end = (bucket + 1) * sampleCount / bucketCount;
+
+            float bucketMin = std::numeric_limits<float>::max();
+            float bucketMax = std::numeric_limits<float>::lowest();
+            float bucketTotal = 0.0f;
+            for (size_t i = begin; i < end; ++i) {
+                bucketMin = std::min(bucketMin, m_samples[i]);
+                bucketMax = std::max(bucketMax, m_samples[i]);
+                bucketTotal += m_samples[i];
+            }
+            outMin[bucket] = bucketMin;
+            outMax[bucket] = bucketMax;
+            outAvg[bucket] = bucketTotal / (float)(end - begin);
+        }
+        return bucketCount;
+    }
+
+private:
+    RingBuffer<float, N> m_samples;
+};
+
+// Collects the per-frame timings that are shown in the performance HUD.
+// Writers are the PPC thread (frame/eye timings) and Cemu's Vulkan thread (copy timings), the reader is the ImGui overlay.
+class PerformanceStats {
+public:
+    static constexpr size_t HISTORY_SIZE = 600;
+    static constexpr size_t PLOT_BUCKETS = 150;
+    using History = SampleHistory<HISTORY_SIZE>;
+    using Clock = std::chrono::steady_clock;
+
+    enum class Graph : uint8_t {
+        FRAME_TIME = 0,
+        LEFT_EYE_CPU = 1,
+        RIGHT_EYE_CPU = 2,
+        GPU_COPY = 3,
+        FENCE_WAIT = 4,
+        POSE_ERROR = 5,
+        FRAME_LOOP_CPU = 6,
+        PACING_ERROR = 7,
+        SWAPCHAIN_WAIT = 8,
+        REPEAT_ERROR = 9,
+        COUNT
+    };
+
+    struct Counters {
+        uint64_t frames = 0;
+        uint64_t droppedFrames = 0;
+        uint64_t duplicatedFrames = 0;
+        uint64_t repeatedFrames = 0; // dropped frames for which the last 3D and 2D layers were submitted again
+        uint64_t fenceLag = 0;
+        uint64_t maxFenceLag = 0;
+    };
+
+    void BeginFrame() {
+        const Clock::time_point now = Clock::now();
+        std::scoped_lock lock(m_mutex);
+        if (m_lastFrameStart != Clock::time_point{}) {
+            GetHistory(Graph::FRAME_TIME).Push(ToMilliseconds(now - m_lastFrameStart));
+        }
+        m_lastFrameStart = now;
+    }
+
+    // dropped means that no new frame from the game was ready to be submitted to the runtime
+    void EndFrame(bool dropped, float fenceWaitMs) {
+        std::scoped_lock lock(m_mutex);
+        m_counters.frames++;
+        if (dropped) {
+            m_counters.droppedFrames++;
+        }
+        GetHistory(Graph::FENCE_WAIT).Push(fenceWaitMs);
+        GetHistory(Graph::GPU_COPY).Push(m_gpuCopyAccumulatedMs);
+        m_gpuCopyAccumulatedMs = 0.0f;
+    }
+
+    void BeginEye(uint8_t side) {
+        m_eyeStart[side & 1] = Clock::now();
+    }
+
+    void EndEye(uint8_t side) {
+        const Clock::time_point start = m_eyeStart[side & 1];
+        if (start == Clock::time_point{})
+            return;
+        const float elapsedMs = ToMilliseconds(Clock::now() - start);
+        std::scoped_lock lock(m_mutex);
+        GetHistory((side & 1) == 0 ? Graph::LEFT_EYE_CPU : Graph::RIGHT_EYE_CPU).Push(elapsedMs);
+    }
+
+    // copies are resolved a frame late, so they're accumulated until the next EndFrame
+    void AddGpuCopyTime(float ms) {
+        std::scoped_lock lock(m_mutex);
+        m_gpuCopyAccumulatedMs += ms;
+    }
+
+    // difference between the head pose that was rendered with and the one predicted right before submitting
+    void AddPoseError(float angleDegrees) {
+        std::scoped_lock lock(m_mutex);
+        GetHistory(Graph::POSE_ERROR).Push(angleDegrees);
+    }
+
+    // difference between the head pose that a repeated 3D layer was rendered with and the current one, which the runtime has to reproject across
+    void AddRepeatError(float angleDegrees) {
+        std::scoped_lock lock(m_mutex);
+        GetHistory(Graph::REPEAT_ERROR).Push(angleDegrees);
+    }
+
+    // CPU time of StartFrame and EndFrame up to xrEndFrame, without the time that was spent blocked in xrWaitFrame
+    void AddFrameLoopTime(float ms) {
+        std::scoped_lock lock(m_mutex);
+        GetHistory(Graph::FRAME_LOOP_CPU).Push(ms);
+    }
+
+    // how far the interval between two predicted display times was from the runtime's display period, a missed vsync shows up as a whole period
+    void AddPacingError(float ms) {
+        std::scoped_lock lock(m_mutex);
+        GetHistory(Graph::PACING_ERROR).Push(ms);
+    }
+
+    // time that was spent blocked in xrWaitSwapchainImage over all swapchains of a frame
+    void AddSwapchainWait(float ms) {
+        std::scoped_lock lock(m_mutex);
+        GetHistory(Graph::SWAPCHAIN_WAIT).Push(ms);
+    }
+
+    void AddDuplicatedFrame() {
+        std::scoped_lock lock(m_mutex);
+        m_counters.duplicatedFrames++;
+    }
+
+    void AddRepeatedFrame() {
+        std::scoped_lock lock(m_mutex);
+        m_counters.repeatedFrames++;
+    }
+
+    void SetFenceLag(uint64_t lag) {
+        std::scoped_lock lock(m_mutex);
+        m_counters.fenceLag = lag;
+        m_counters.maxFenceLag = std::max(m_counters.maxFenceLag, lag);
+    }
+
+    void Reset() {
+        std::scoped_lock lock(m_mutex);
+        for (auto& history : m_histories) {
+            history.Clear();
+        }
+        m_counters = {};
+        m_gpuCopyAccumulatedMs = 0.0f;
+    }
+
+    // Copies out everything the HUD needs while holding the lock once, so drawing never blocks the writers
+    struct Snapshot {
+        struct Plot {
+            std::array<float, PLOT_BUCKETS> min;
+            std::array<float, PLOT_BUCKETS> max;
+            std::array<float, PLOT_BUCKETS> avg;
+            size_t count = 0;
+            History::Summary summary;
+        };
+        std::array<Plot, (size_t)Graph::COUNT> plots;
+        Counters counters;
+    };
+
+    void TakeSnapshot(Snapshot& snapshot) const {
+        std::scoped_lock lock(m_mutex);
+        for (size_t i = 0; i < (size_t)Graph::COUNT; ++i) {
+            auto& plot = snapshot.plots[i];
+            plot.count = m_histories[i].Downsample(plot.min, plot.max, plot.avg);
+            plot.summary = m_histories[i].Summarize();
+        }
+        snapshot.counters = m_counters;
+    }
+
+    static const char* GetGraphName(Graph graph) {
+        switch (graph) {
+            case Graph::FRAME_TIME: return "Frame Time";
+            case Graph::LEFT_EYE_CPU: return "Left Eye CPU";
+            case Graph::RIGHT_EYE_CPU: return "Right Eye CPU";
+            case Graph::GPU_COPY: return "GPU Copy";
+            case Graph::FENCE_WAIT: return "Fence Wait";
+            case Graph::POSE_ERROR: return "Pose Error";
+            case Graph::FRAME_LOOP_CPU: return "Frame Loop CPU";
+            case Graph::PACING_ERROR: return "Pacing Error";
+            case Graph::SWAPCHAIN_WAIT: return "Swapchain Wait";
+            case Graph::REPEAT_ERROR: return "Repeat Error";
+            default: return "Unknown";
+        }
+    }
+
+    static const char* GetGraphUnit(Graph graph) {
+        return graph == Graph::POSE_ERROR || graph == Graph::REPEAT_ERROR ? "deg" : "ms";
+    }
+
+private:
+    History& GetHistory(Graph graph) { return m_histories[(size_t)graph]; }
+
+    static float ToMilliseconds(Clock::duration duration) {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+
+    mutable std::mutex m_mutex;
+    std::array<History, (size_t)Graph::COUNT> m_histories;
+    Counters m_counters;
+    float m_gpuCopyAccumulatedMs = 0.0f;
+
+    Clock::time_point m_lastFrameStart = {};
+    std::array<Clock::time_point, 2> m_eyeStart = {};
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Difference between the pose something was rendered with and a later, more accurate prediction of the same pose
+struct PoseDelta {
+    glm::fvec3 translation = glm::fvec3(0.0f); // submit position - render position
+    glm::fquat rotation = glm::fquat(1.0f, 0.0f, 0.0f, 0.0f); // rotation that takes the render orientation to the submit orientation
+    float positionError = 0.0f; // in meters
+    float angleError = 0.0f; // in radians
+
+    static PoseDelta Compute(const glm::fvec3& renderPosition, const glm::fquat& renderOrientation, const glm::fvec3& submitPosition, const glm::fquat& submitOrientation) {
+        PoseDelta delta;
+        delta.translation = submitPosition - renderPosition;
+        delta.rotation = glm::normalize(submitOrientation * glm::inverse(renderOrientation));
+        delta.positionError = glm::length(delta.translation);
+        // q and -q are the same rotation, so use the shortest arc
+        delta.angleError = 2.0f * std::acos(std::min(std::abs(delta.rotation.w), 1.0f));
+        return delta;
+    }
+
+    // applies the delta to a pose that was rendered with, giving the pose as predicted at submit time
+    void Apply(glm::fvec3& position, glm::fquat& orientation) const {
+        position += translation;
+        orientation = glm::normalize(rotation * orientation);
+    }
+};
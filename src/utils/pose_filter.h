@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// One Euro filter (Casiez et al.), a low-pass filter whose cutoff frequency rises with the speed of the signal.
+// Slow movements are smoothed heavily to remove jitter, fast movements barely at all so they don't lag behind.
+class OneEuroFilter {
+public:
+    struct Settings {
+        float minCutoff = 1.0f; // in Hz, the cutoff when the signal isn't moving
+        float beta = 0.5f; // how much the cutoff rises with speed
+        float derivativeCutoff = 1.0f; // in Hz, for smoothing the speed itself
+    };
+
+    static float Alpha(float cutoff, float deltaSeconds) {
+        const float tau = 1.0f / (2.0f * std::numbers::pi_v<float> * cutoff);
+        return 1.0f / (1.0f + tau / deltaSeconds);
+    }
+
+    // returns the smoothing factor to blend the previous value towards the new one with, given how fast the signal moves
+    float Update(float speed, float deltaSeconds, const Settings& settings) {
+        m_speed = m_initialized ? m_speed + Alpha(settings.derivativeCutoff, deltaSeconds) * (speed - m_speed) : speed;
+        m_initialized = true;
+        return Alpha(settings.minCutoff + settings.beta * std::abs(m_speed), deltaSeconds);
+    }
+
+    void Reset() { m_initialized = false; }
+
+private:
+    float m_speed = 0.0f;
+    bool m_initialized = false;
+};
+
+// Smooths a tracked controller pose, predicts it ahead by its velocity and rides out short tracking losses.
+// Updated once per frame with the raw pose, the filtered pose is published next to the raw one so that every consumer sees the same result.
+class ControllerPoseFilter {
+public:
+    struct Settings {
+        OneEuroFilter::Settings position = { .minCutoff = 1.5f, .beta = 4.0f, .derivativeCutoff = 1.0f }; // speed in m/s
+        OneEuroFilter::Settings orientation = { .minCutoff = 1.5f, .beta = 0.5f, .derivativeCutoff = 1.0f }; // speed in rad/s
+        float maxJumpMeters = 0.3f; // a jump that the velocity doesn't account for is treated as a tracking glitch
+        float maxCoastSeconds = 0.1f; // how long the last pose is extrapolated when tracking is lost
+        float maxDeltaSeconds = 0.1f; // longer gaps restart the filter
+    };
+
+    struct Sample {
+        glm::fvec3 position;
+        glm::fquat orientation;
+        glm::fvec3 linearVelocity; // in m/s
+        glm::fvec3 angularVelocity; // in rad/s
+        bool positionValid;
+        bool orientationValid;
+        bool velocityValid;
+    };
+
+    struct Result {
+        glm::fvec3 position;
+        glm::fquat orientation;
+        bool valid; // false if there was no tracking for longer than the coasting time
+        bool coasting; // true while the pose is extrapolated because tracking was lost
+    };
+
+    ControllerPoseFilter() = default;
+    explicit ControllerPoseFilter(const Settings& settings): m_settings(settings) {}
+
+    void Reset() {
+        m_initialized = false;
+        m_coastSeconds = 0.0f;
+        m_positionFilter.Reset();
+        m_orientationFilter.Reset();
+    }
+
+    // predictionSeconds extrapolates the filtered pose by its velocity, e.g. to the time the game's frame will be shown
+    Result Update(const Sample& sample, float deltaSeconds, float predictionSeconds) {
+        if (deltaSeconds <= 0.0f || deltaSeconds > m_settings.maxDeltaSeconds) {
+            Reset();
+            deltaSeconds = 1.0f / 90.0f;
+        }
+        predictionSeconds = std::clamp(predictionSeconds, 0.0f, m_settings.maxDeltaSeconds);
+
+        const bool tracked = sample.positionValid && sample.orientationValid;
+        const bool isOutlier = tracked && m_initialized && !m_coasting && IsJump(sample, deltaSeconds);
+        if (!tracked || isOutlier) {
+            return Coast(deltaSeconds, predictionSeconds);
+        }
+
+        // tracking came back, start over from the new pose instead of smoothing across the gap
+        if (m_coasting) {
+            Reset();
+        }
+        m_coasting = false;
+        m_coastSeconds = 0.0f;
+
+        m_linearVelocity = sample.velocityValid ? sample.linearVelocity : glm::fvec3(0.0f);
+        m_angularVelocity = sample.velocityValid ? sample.angularVelocity : glm::fvec3(0.0f);
+
+        if (!m_initialized) {
+            m_initialized = true;
+            m_position = sample.position;
+            m_orientation = sample.orientation;
+        }
+        else {
+            const float positionSpeed = sample.velocityValid ? glm::length(sample.linearVelocity) : glm::length(sample.position - m_position) / deltaSeconds;
+            const float orientationSpeed = sample.velocityValid ? glm::length(sample.angularVelocity) : AngleBetween(m_orientation, sample.orientation) / deltaSeconds;
+            m_position = glm::mix(m_position, sample.position, m_positionFilter.Update(positionSpeed, deltaSeconds, m_settings.position));
+            m_orientation = glm::normalize(glm::slerp(m_orientation, sample.orientation, m_orientationFilter.Update(orientationSpeed, deltaSeconds, m_settings.orientation)));
+        }
+        return Predict(predictionSeconds, true, false);
+    }
+
+    const Settings& GetSettings() const { return m_settings; }
+
+private:
+    static float AngleBetween(const glm::fquat& a, const glm::fquat& b) {
+        return 2.0f * std::acos(std::min(std::abs(glm::dot(a, b)), 1.0f));
+    }
+
+    bool IsJump(const Sample& sample, float deltaSeconds) const {
+        const glm::fvec3 expected = m_position + m_linearVelocity * deltaSeconds;
+        return glm::length(sample.position - expected) > m_settings.maxJumpMeters;
+    }
+
+    Result Coast(float deltaSeconds, float predictionSeconds) {
+        if (!m_initialized) {
+            return { m_position, m_orientation, false, false };
+        }
+        m_coasting = true;
+        m_coastSeconds += deltaSeconds;
+        if (m_coastSeconds > m_settings.maxCoastSeconds) {
+            return { m_position, m_orientation, false, true };
+        }
+        // keep moving with the last known velocity, which is much less jarring than freezing the hand
+        Advance(deltaSeconds);
+        return Predict(predictionSeconds, true, true);
+    }
+
+    void Advance(float seconds) {
+        m_position += m_linearVelocity * seconds;
+        const float angularSpeed = glm::length(m_angularVelocity);
+        if (angularSpeed > 1e-4f) {
+            m_orientation = glm::normalize(glm::angleAxis(angularSpeed * seconds, m_angularVelocity / angularSpeed) * m_orientation);
+        }
+    }
+
+    Result Predict(float seconds, bool valid, bool coasting) const {
+        Result result = { m_position + m_linearVelocity * seconds, m_orientation, valid, coasting };
+        const float angularSpeed = glm::length(m_angularVelocity);
+        if (angularSpeed > 1e-4f) {
+            result.orientation = glm::normalize(glm::angleAxis(angularSpeed * seconds, m_angularVelocity / angularSpeed) * m_orientation);
+        }
+        return result;
+    }
+
+    Settings m_settings;
+    OneEuroFilter m_positionFilter;
+    OneEuroFilter m_orientationFilter;
+    bool m_initialized = false;
+    bool m_coasting = false;
+    float m_coastSeconds = 0.0f;
+    glm::fvec3 m_position = glm::fvec3(0.0f);
+    glm::fquat m_orientation = glm::fquat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::fvec3 m_linearVelocity = glm::fvec3(0.0f);
+    glm::fvec3 m_angularVelocity = glm::fvec3(0.0f);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// note: this file intentionally only depends on the standard library so that it can be used outside of the layer
+
+// Filter selection for the present pass, the kernels themselves live in the present shaders (src/shader.h).
+namespace PresentKernels {
+    // must match the FILTER_* constants in the present shaders
+    enum class Filter : uint32_t {
+        POINT = 0,
+        BILINEAR = 1,
+        BOX = 2,
+        BICUBIC = 3,
+        AUTO = UINT32_MAX
+    };
+
+    // each bilinear tap of the box filter averages up to 2x2 texels, so this many taps per axis cover downsampling ratios of up to 2 * MAX_BOX_TAPS
+    constexpr uint32_t MAX_BOX_TAPS = 4;
+
+    // Picks the cheapest filter that doesn't alias for the given source -> destination sizes
+    inline Filter SelectFilter(uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight) {
+        if (srcWidth == dstWidth && srcHeight == dstHeight)
+            return Filter::POINT;
+        const float ratio = std::max((float)srcWidth / (float)dstWidth, (float)srcHeight / (float)dstHeight);
+        if (ratio >= 1.5f)
+            return Filter::BOX;
+        if (ratio < 1.0f)
+            return Filter::BICUBIC;
+        return Filter::BILINEAR;
+    }
+
+    inline const char* GetFilterName(Filter filter) {
+        switch (filter) {
+            case Filter::POINT: return "Point";
+            case Filter::BILINEAR: return "Bilinear";
+            case Filter::BOX: return "Box";
+            case Filter::BICUBIC: return "Bicubic";
+            default: return "Auto";
+        }
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// What the OpenXR runtime reported at the last launch, stored in a small binary file so that later launches can skip enumerating it again.
+// The key identifies the runtime before an instance exists (the active runtime's manifest and when it was last changed), everything else is
+// validated once the instance is created and rewritten when the runtime, its version or the GPU that it renders on has changed.
+namespace ProbeCache {
+    constexpr uint32_t MAGIC = 0x50525642; // "BVRP"
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr size_t HEADER_SIZE = sizeof(uint32_t) * 3 + sizeof(uint64_t);
+
+    struct Key {
+        std::string runtimeManifest;
+        uint64_t manifestWriteTime = 0;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct Entry {
+        Key key;
+        std::string runtimeName;
+        uint64_t runtimeVersion = 0;
+        std::array<uint8_t, 8> adapterLuid = {};
+        std::vector<std::string> instanceExtensions;
+
+        bool operator==(const Entry&) const = default;
+    };
+
+    // FNV-1a, only used to catch truncated or otherwise damaged files
+    inline uint64_t Checksum(std::span<const uint8_t> data) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (uint8_t byte : data) {
+            hash = (hash ^ byte) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    namespace Detail {
+        inline void Write(std::vector<uint8_t>& out, const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        }
+
+        template <typename T>
+        void WriteValue(std::vector<uint8_t>& out, T value) { Write(out, &value, sizeof(T)); }
+
+        inline void WriteString(std::vector<uint8_t>& out, const std::string& str) {
+            WriteValue<uint32_t>(out, (uint32_t)str.size());
+            Write(out, str.data(), str.size());
+        }
+
+        class Reader {
+        public:
+            explicit Reader(std::span<const uint8_t> data): m_data(data) {}
+
+            template <typename T>
+            bool ReadValue(T& value) {
+                if (m_data.size() - m_offset < sizeof(T))
+                    return false;
+                std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+                m_offset += sizeof(T);
+                return true;
+            }
+
+            bool ReadString(std::string& str) {
+                uint32_t size = 0;
+                if (!ReadValue(size) || m_data.size() - m_offset < size)
+                    return false;
+                str.assign(reinterpret_cast<const char*>(m_data.data() + m_offset), size);
+                m_offset += size;
+                return true;
+            }
+
+            bool AtEnd() const { return m_offset == m_data.size(); }
+
+        private:
+            std::span<const uint8_t> m_data;
+            size_t m_offset = 0;
+        };
+    }
+
+    inline std::vector<uint8_t> Serialize(const Entry& entry) {
+        std::vector<uint8_t> payload;
+        Detail::WriteString(payload, entry.key.runtimeManifest);
+        Detail::WriteValue(payload, entry.key.manifestWriteTime);
+        Detail::WriteString(payload, entry.runtimeName);
+        Detail::WriteValue(payload, entry.runtimeVersion);
+        Detail::Write(payload, entry.adapterLuid.data(), entry.adapterLuid.size());
+        Detail::WriteValue<uint32_t>(payload, (uint32_t)entry.instanceExtensions.size());
+        for (const std::string& extension : entry.instanceExtensions) {
+            Detail::WriteString(payload, extension);
+        }
+
+        std::vector<uint8_t> file;
+        file.reserve(HEADER_SIZE + payload.size());
+        Detail::WriteValue(file, MAGIC);
+        Detail::WriteValue(file, FORMAT_VERSION);
+        Detail::WriteValue<uint32_t>(file, (uint32_t)payload.size());
+        Detail::WriteValue(file, Checksum(payload));
+        file.insert(file.end(), payload.begin(), payload.end());
+        return file;
+    }
+
+    // returns nothing if the data is from another format version or damaged in any way
+    inline std::optional<Entry> Deserialize(std::span<const uint8_t> data) {
+        Detail::Reader header(data.first(std::min(data.size(), HEADER_SIZE)));
+        uint32_t magic = 0, formatVersion = 0, payloadSize = 0;
+        uint64_t checksum = 0;
+        if (!header.ReadValue(magic) || !header.ReadValue(formatVersion) || !header.ReadValue(payloadSize) || !header.ReadValue(checksum))
+            return std::nullopt;
+        if (magic != MAGIC || formatVersion != FORMAT_VERSION || data.size() - HEADER_SIZE != payloadSize)
+            return std::nullopt;
+
+        const std::span<const uint8_t> payload = data.subspan(HEADER_SIZE);
+        if (Checksum(payload) != checksum)
+            return std::nullopt;
+
+        Detail::Reader reader(payload);
+        Entry entry;
+        uint32_t extensionCount = 0;
+        if (!reader.ReadString(entry.key.runtimeManifest) || !reader.ReadValue(entry.key.manifestWriteTime) || !reader.ReadString(entry.runtimeName) || !reader.ReadValue(entry.runtimeVersion) || !reader.ReadValue(entry.adapterLuid) || !reader.ReadValue(extensionCount))
+            return std::nullopt;
+        for (uint32_t i = 0; i < extensionCount; i++) {
+            if (!reader.ReadString(entry.instanceExtensions.emplace_back()))
+                return std::nullopt;
+        }
+        if (!reader.AtEnd())
+            return std::nullopt;
+        return entry;
+    }
+
+    // returns the cached entry only if it was stored for the same key
+    inline std::optional<Entry> Load(const std::filesystem::path& path, const Key& key) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return std::nullopt;
+        const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::optional<Entry> entry = Deserialize(data);
+        if (!entry || entry->key != key)
+            return std::nullopt;
+        return entry;
+    }
+
+    // writes to a temporary file first, so that a crash halfway through never leaves a partial cache behind
+    inline bool Store(const std::filesystem::path& path, const Entry& entry) {
+        const std::vector<uint8_t> data = Serialize(entry);
+        std::filesystem::path tempPath = path;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size()))
+                return false;
+        }
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        return !error;
+    }
+
+    inline void Invalidate(const std::filesystem::path& path) {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+}
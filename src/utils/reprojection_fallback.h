@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// Decides whether the last submitted 3D layer is submitted again when the game didn't finish a frame in time.
+// A repeated layer keeps the poses it was rendered with along with its depth, so the runtime reprojects it to the current head pose,
+// which judders far less than leaving the 3D layer out for a frame.
+// Layers are only repeated for a limited number of frames in a row, since a longer gap means the game is loading or paused and a frozen world would be worse.
+class ReprojectionFallback {
+public:
+    static constexpr uint32_t DEFAULT_MAX_REPEATS = 8;
+
+    enum class Decision {
+        SUBMIT_NEW,
+        REPEAT_LAST,
+        SKIP
+    };
+
+    ReprojectionFallback() = default;
+    explicit ReprojectionFallback(uint32_t maxRepeats): m_maxRepeats(maxRepeats) {}
+
+    // hasNewFrame is whether the game completed a 3D frame since the last call, canSubmit whether a 3D layer should be visible at all
+    Decision Decide(bool hasNewFrame, bool canSubmit) {
+        if (!canSubmit) {
+            Invalidate();
+            return Decision::SKIP;
+        }
+        if (hasNewFrame) {
+            m_hasSubmitted = true;
+            m_repeats = 0;
+            return Decision::SUBMIT_NEW;
+        }
+        if (!m_hasSubmitted || m_repeats >= m_maxRepeats) {
+            return Decision::SKIP;
+        }
+        m_repeats++;
+        return Decision::REPEAT_LAST;
+    }
+
+    // the last submitted layer can't be repeated anymore, e.g. because it was shown before a loading screen
+    void Invalidate() {
+        m_hasSubmitted = false;
+        m_repeats = 0;
+    }
+
+    uint32_t GetRepeatCount() const { return m_repeats; }
+    uint32_t GetMaxRepeats() const { return m_maxRepeats; }
+
+private:
+    uint32_t m_maxRepeats = DEFAULT_MAX_REPEATS;
+    uint32_t m_repeats = 0;
+    bool m_hasSubmitted = false;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "pch.h"
+
+#include <initializer_list>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+
+// Tracks the type of every semaphore Cemu creates.
+// CreateSemaphore/DestroySemaphore and QueueSubmit can be called from different threads, so all access goes through a reader/writer lock.
+// Lookups are meant to be batched so that a submit only takes the lock once, regardless of how many semaphores it uses.
+class SemaphoreTable {
+public:
+    void Insert(VkSemaphore semaphore, const VkSemaphoreCreateInfo* pCreateInfo) {
+        VkSemaphoreType type = VK_SEMAPHORE_TYPE_BINARY;
+        if (const auto* typeInfo = vkroots::FindInChain<VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO, const VkSemaphoreCreateInfo>(pCreateInfo->pNext)) {
+            type = typeInfo->semaphoreType;
+        }
+
+        std::unique_lock lock(m_mutex);
+        // handles can be reused after being destroyed, so replace any stale entry
+        m_semaphores.insert_or_assign(semaphore, type);
+    }
+
+    void Erase(VkSemaphore semaphore) {
+        std::unique_lock lock(m_mutex);
+        m_semaphores.erase(semaphore);
+    }
+
+    // whether any of the given semaphores is a timeline semaphore, semaphores that weren't created through the layer count as binary
+    bool ContainsTimeline(std::initializer_list<std::span<const VkSemaphore>> semaphoreLists) const {
+        std::shared_lock lock(m_mutex);
+        for (const auto& semaphores : semaphoreLists) {
+            for (VkSemaphore semaphore : semaphores) {
+                if (const auto it = m_semaphores.find(semaphore); it != m_semaphores.end() && it->second == VK_SEMAPHORE_TYPE_TIMELINE)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<VkSemaphore, VkSemaphoreType> m_semaphores;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+
+// Pose algebra on OpenXR locations, where a location is the pose of a space expressed in a base space along with its validity flags.
+namespace SpaceRelations {
+    constexpr XrSpaceLocationFlags POSE_VALID_BITS = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+
+    inline XrPosef Inverse(const XrPosef& pose) {
+        const glm::fquat inverseOrientation = glm::inverse(ToGLM(pose.orientation));
+        return { ToXR(inverseOrientation), ToXR(inverseOrientation * -ToGLM(pose.position)) };
+    }
+
+    // pose of child (expressed in parent) brought into the space that parent is expressed in
+    inline XrPosef Compose(const XrPosef& parent, const XrPosef& child) {
+        const glm::fquat parentOrientation = ToGLM(parent.orientation);
+        return { ToXR(glm::normalize(parentOrientation * ToGLM(child.orientation))), ToXR(ToGLM(parent.position) + parentOrientation * ToGLM(child.position)) };
+    }
+
+    // Location of target relative to base, when both are located in the same space.
+    // The position needs both positions and the base's orientation, the orientation needs both orientations, the same goes for the tracked bits.
+    inline XrSpaceLocation Relate(const XrSpaceLocation& base, const XrSpaceLocation& target) {
+        auto combineFlags = [&](XrSpaceLocationFlags positionBit, XrSpaceLocationFlags orientationBit) -> XrSpaceLocationFlags {
+            XrSpaceLocationFlags flags = 0;
+            if ((base.locationFlags & positionBit) && (target.locationFlags & positionBit) && (base.locationFlags & orientationBit))
+                flags |= positionBit;
+            if ((base.locationFlags & orientationBit) && (target.locationFlags & orientationBit))
+                flags |= orientationBit;
+            return flags;
+        };
+
+        XrSpaceLocation relation = { XR_TYPE_SPACE_LOCATION };
+        relation.locationFlags = combineFlags(XR_SPACE_LOCATION_POSITION_VALID_BIT, XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) | combineFlags(XR_SPACE_LOCATION_POSITION_TRACKED_BIT, XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT);
+        relation.pose = Compose(Inverse(base.pose), target.pose);
+        return relation;
+    }
+}
+
+// Locates every tracked space against the stage once per display time, since each xrLocateSpace can be a call into the runtime's process.
+// Any other relation between the tracked spaces (e.g. a hand relative to the head) is derived from the cached stage locations.
+class SpaceRelationCache {
+public:
+    enum Space : uint8_t {
+        HEAD,
+        LEFT_HAND,
+        RIGHT_HAND,
+        COUNT
+    };
+
+    struct Location {
+        XrSpaceLocation location;
+        XrSpaceVelocity velocity;
+    };
+
+    void SetSpaces(XrSpace stageSpace, const std::array<XrSpace, COUNT>& spaces) {
+        std::scoped_lock lock(m_mutex);
+        m_stageSpace = stageSpace;
+        m_spaces = spaces;
+        m_displayTime = 0;
+    }
+
+    // location of the space in the stage, including its velocity if the runtime provides it
+    Location Locate(Space space, XrTime displayTime) {
+        std::scoped_lock lock(m_mutex);
+        return LocateLocked(space, displayTime);
+    }
+
+    // location of target relative to base, without locating either of them again if they already were for this display time
+    XrSpaceLocation Relate(Space base, Space target, XrTime displayTime) {
+        std::scoped_lock lock(m_mutex);
+        const XrSpaceLocation baseLocation = LocateLocked(base, displayTime).location;
+        return SpaceRelations::Relate(baseLocation, LocateLocked(target, displayTime).location);
+    }
+
+    uint64_t GetLocateCount() const {
+        std::scoped_lock lock(m_mutex);
+        return m_locateCount;
+    }
+
+private:
+    const Location& LocateLocked(Space space, XrTime displayTime) {
+        if (displayTime != m_displayTime) {
+            m_displayTime = displayTime;
+            m_located = {};
+        }
+
+        Location& entry = m_locations[space];
+        if (!m_located[space]) {
+            m_located[space] = true;
+            m_locateCount++;
+            entry.location = { XR_TYPE_SPACE_LOCATION };
+            entry.velocity = { XR_TYPE_SPACE_VELOCITY };
+            entry.location.next = &entry.velocity;
+            if (XR_FAILED(xrLocateSpace(m_spaces[space], m_stageSpace, displayTime, &entry.location))) {
+                entry.location.locationFlags = 0;
+                entry.velocity.velocityFlags = 0;
+            }
+            entry.location.next = nullptr;
+        }
+        return entry;
+    }
+
+    mutable std::mutex m_mutex;
+    XrSpace m_stageSpace = XR_NULL_HANDLE;
+    std::array<XrSpace, COUNT> m_spaces = {};
+    XrTime m_displayTime = 0;
+    std::array<bool, COUNT> m_located = {};
+    std::array<Location, COUNT> m_locations = {};
+    uint64_t m_locateCount = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// N has to be a power of two, so that the indices can keep counting up and be wrapped with a mask.
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue size has to be a power of two");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    // producer only, returns false without pushing if the queue is full
+    bool TryPush(const T& value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == N)
+            return false;
+        m_items[tail & (N - 1)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    std::optional<T> TryPop() {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return std::nullopt;
+        T value = m_items[head & (N - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // producer only, whether a push would currently succeed
+    bool HasSpace() const {
+        return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire) < N;
+    }
+
+private:
+    std::array<T, N> m_items = {};
+    // on separate cache lines, since each one is written by a different thread
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+};